@@ -0,0 +1,338 @@
+// Copyright (c) 1981-86 Robert A. Koeneke
+// Copyright (c) 1987-94 James E. Wilson
+//
+// This work is free software released under the GNU General Public License
+// version 2.0, and comes with ABSOLUTELY NO WARRANTY.
+//
+// See LICENSE and AUTHORS for more information.
+
+// Batch runner: plays many seeded headless games in parallel
+
+#include "headers.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static const char *usage_instructions = R"(
+Usage:
+    umoria-batch [OPTIONS] KEYSCRIPT
+    umoria-batch [OPTIONS] -b
+
+Plays a batch of headless games, one for each seed, all of them
+reading their keys from KEYSCRIPT, and reports aggregate stats.
+
+With -b, the games are the monster benchmark instead: a wizard goes
+down to dungeon level 5, fills the whole level with awake monsters,
+leaves wizard mode and searches for a thousand turns while they close
+in, healed every turn so that none of them is cut short. Only those
+turns are timed.
+
+Options:
+    -g NUMBER    Number of games to play (default: 100)
+    -j NUMBER    Number of games to play at the same time (default: number of cores)
+    -s NUMBER    Seed of the first game, each next game adds one (default: 1)
+    -o FILE      Also write the results of every game to FILE, as CSV
+    -m           Never stop for -more-, KEYSCRIPT has no keys for it
+    -b           Play the monster benchmark rather than a KEYSCRIPT
+    -n NUMBER    Monsters for the benchmark to fill the level with (default: 125)
+
+    -h           Display this message
+)";
+
+// The outcome of a single game
+typedef struct {
+    uint32_t seed;
+    int32_t turns;
+    double seconds;
+    bool died;
+    int16_t dungeon_level;
+    uint16_t max_dungeon_depth;
+    uint16_t character_level;
+    int32_t exp;
+    int32_t object_compactions;
+    int32_t monster_compactions;
+    vtype_t died_from;
+} GameResult_t;
+
+static const char *key_script = nullptr;
+static bool batch_messages = false;
+static bool benchmark = false;
+static int benchmark_monsters = 125;
+
+// The monster benchmark: a character with plenty of hit points on dungeon level 5, set
+// up in wizard mode, which is then left so that only the monsters in sight are lit
+static const char *benchmark_start_keys = " am\x1b" "aBob\r \x17 y\x05\r\r\r\r\r\r30000\r\x1b\x04" "5\r\x17";
+constexpr int BENCHMARK_TURNS = 1000;
+
+static thread_local const char *benchmark_next_key;
+static thread_local bool benchmark_level_filled;
+static thread_local int benchmark_turns_left;
+
+// Up to `benchmark_monsters` monsters on the level, as many as there is room
+// for, and every one of them awake
+static void benchmarkFillLevel() {
+    int monsters_wanted = benchmark_monsters;
+
+    for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+        if (!monsterSlotIsFree(id)) {
+            monsters_wanted--;
+        }
+    }
+
+    int empty_tiles = 0;
+
+    for (int y = 1; y < dg.height - 1; y++) {
+        for (int x = 1; x < dg.width - 1; x++) {
+            if (dg.floor.feature_ids[y][x] <= MAX_OPEN_SPACE && dg.floor.creature_ids[y][x] == 0) {
+                empty_tiles++;
+            }
+        }
+    }
+
+    // Some room is left, or finding a spot for the last ones takes forever
+    monsters_wanted = std::min(std::min(monsters_wanted, empty_tiles / 2), monsterSlotsLeft());
+    monsterPlaceNewWithinDistance(monsters_wanted, 0, false);
+
+    for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+        monsters[id].sleep_count = 0;
+    }
+}
+
+// The keys of the monster benchmark, handed out one by one as the game asks for them
+static int benchmarkKey() {
+    if (*benchmark_next_key != '\0') {
+        return (uint8_t) *benchmark_next_key++;
+    }
+
+    if (benchmark_turns_left == 0) {
+        return -1;
+    }
+
+    if (!benchmark_level_filled) {
+        benchmarkFillLevel();
+        benchmark_level_filled = true;
+
+        // Neither the way down nor filling the level count towards the turn cost
+        simulationTimerStart();
+    }
+
+    // The monsters must not end the run early, that would leave its turns out
+    py.misc.current_hp = py.misc.max_hp;
+
+    benchmark_turns_left--;
+    return 's';
+}
+
+// Plays one complete game in the calling thread, which must be a fresh
+// thread, as all game state is `thread_local` and starts out zeroed.
+static void playGame(GameResult_t &result) {
+    if (!terminalInitializeHeadless(key_script)) {
+        (void) strcpy(result.died_from, "(no key script)");
+        return;
+    }
+
+    config::options::batch_messages = batch_messages;
+
+    if (benchmark) {
+        benchmark_next_key = benchmark_start_keys;
+        benchmark_level_filled = false;
+        benchmark_turns_left = BENCHMARK_TURNS;
+        terminalSetHeadlessInputCallback(benchmarkKey);
+
+        // The monsters' attacks would have the wizard keep answering -more-
+        config::options::batch_messages = true;
+    }
+
+    try {
+        startMoria((int) result.seed, true);
+    } catch (const GameExit_t &) {
+        // The game is over
+    }
+
+    result.turns = simulationTurns();
+    result.seconds = simulationSeconds();
+    result.died = game.character_is_dead;
+    result.dungeon_level = dg.current_level;
+    result.max_dungeon_depth = py.misc.max_dungeon_depth;
+    result.character_level = py.misc.level;
+    result.exp = py.misc.exp;
+    result.object_compactions = game.compactions.objects;
+    result.monster_compactions = game.compactions.monsters;
+    (void) strcpy(result.died_from, game.character_died_from);
+}
+
+// Each worker takes the next game to play until there are none left. Every game gets
+// a thread of its own, so its `thread_local` state never carries over into the next game.
+static void playGames(std::vector<GameResult_t> &results, std::atomic<size_t> &next_game) {
+    size_t game_id;
+
+    while ((game_id = next_game++) < results.size()) {
+        std::thread(playGame, std::ref(results[game_id])).join();
+    }
+}
+
+static bool writeResultsFile(const char *filename, std::vector<GameResult_t> const &results) {
+    FILE *file = fopen(filename, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    (void) fprintf(file, "seed,turns,seconds,died,dungeon_level,max_dungeon_depth,character_level,exp,object_compactions,monster_compactions,died_from\n");
+
+    for (auto const &result : results) {
+        (void) fprintf(file,                                                   //
+                       "%u,%d,%.6f,%d,%d,%d,%d,%d,%d,%d,\"%s\"\n",             //
+                       result.seed, result.turns, result.seconds,              //
+                       (int) result.died, result.dungeon_level,                //
+                       result.max_dungeon_depth, result.character_level,       //
+                       result.exp,                                             //
+                       result.object_compactions, result.monster_compactions, //
+                       result.died_from                                        //
+        );
+    }
+
+    return fclose(file) == 0;
+}
+
+static void printAggregateStats(std::vector<GameResult_t> const &results, int threads, double seconds) {
+    int deaths = 0;
+    int64_t total_turns = 0;
+    double game_seconds = 0;
+    int32_t min_turns = INT32_MAX;
+    int32_t max_turns = 0;
+    int total_depth = 0;
+    int deepest = 0;
+    int total_level = 0;
+    int highest_level = 0;
+    int64_t object_compactions = 0;
+    int64_t monster_compactions = 0;
+
+    for (auto const &result : results) {
+        if (result.died) {
+            deaths++;
+        }
+
+        total_turns += result.turns;
+        game_seconds += result.seconds;
+        min_turns = std::min(min_turns, result.turns);
+        max_turns = std::max(max_turns, result.turns);
+
+        total_depth += result.max_dungeon_depth;
+        deepest = std::max(deepest, (int) result.max_dungeon_depth);
+
+        total_level += result.character_level;
+        highest_level = std::max(highest_level, (int) result.character_level);
+
+        object_compactions += result.object_compactions;
+        monster_compactions += result.monster_compactions;
+    }
+
+    auto games = (double) results.size();
+
+    printf("Games played:     %d (%d died)\n", (int) results.size(), deaths);
+    printf("Game turns:       %lld total, %.1f mean, %d min, %d max\n", (long long) total_turns, total_turns / games, min_turns, max_turns);
+    printf("Turn cost:        %.2f microseconds mean\n", total_turns > 0 ? game_seconds * 1000000 / total_turns : 0);
+    printf("Max depth:        %.2f mean, %d deepest\n", total_depth / games, deepest);
+    printf("Character level:  %.2f mean, %d highest\n", total_level / games, highest_level);
+    printf("Compactions:      %lld objects, %lld monsters\n", (long long) object_compactions, (long long) monster_compactions);
+    printf("Wall time:        %.3f seconds on %d threads (%.1f turns/second)\n", seconds, threads, seconds > 0 ? total_turns / seconds : 0);
+}
+
+static bool parseNumber(const char *str, int &number) {
+    return str != nullptr && stringToNumber(str, number) && number > 0;
+}
+
+int main(int argc, char *argv[]) {
+    int games = 100;
+    int threads = (int) std::thread::hardware_concurrency();
+    int first_seed = 1;
+    const char *results_file = nullptr;
+
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    for (--argc, ++argv; argc > 0 && argv[0][0] == '-'; --argc, ++argv) {
+        bool valid;
+
+        switch (argv[0][1]) {
+            case 'g':
+                valid = parseNumber(argv[1], games);
+                break;
+            case 'j':
+                valid = parseNumber(argv[1], threads);
+                break;
+            case 's':
+                valid = parseNumber(argv[1], first_seed);
+                break;
+            case 'n':
+                valid = parseNumber(argv[1], benchmark_monsters);
+                break;
+            case 'o':
+                results_file = argv[1];
+                valid = results_file != nullptr;
+                break;
+            case 'm':
+                batch_messages = true;
+                continue;
+            case 'b':
+                benchmark = true;
+                continue;
+            default:
+                printf("%s", usage_instructions);
+                return 0;
+        }
+
+        if (!valid) {
+            printf("Option -%c needs a positive number, or a filename for -o\n", argv[0][1]);
+            return 1;
+        }
+
+        --argc;
+        ++argv;
+    }
+
+    if (argc != (benchmark ? 0 : 1)) {
+        printf("%s", usage_instructions);
+        return 1;
+    }
+    if (!benchmark) {
+        key_script = argv[0];
+    }
+
+    // Any failure to read the key script shows up here, rather than in every game.
+    if (!terminalInitializeHeadless(key_script)) {
+        std::cerr << "Can't open key script '" << key_script << "'\n";
+        return 1;
+    }
+
+    std::vector<GameResult_t> results((size_t) games, GameResult_t{});
+    for (int i = 0; i < games; i++) {
+        results[i].seed = (uint32_t) first_seed + (uint32_t) i;
+    }
+
+    std::atomic<size_t> next_game(0);
+    std::vector<std::thread> workers;
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(playGames, std::ref(results), std::ref(next_game));
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+    printAggregateStats(results, threads, elapsed.count());
+
+    if (results_file != nullptr && !writeResultsFile(results_file, results)) {
+        std::cerr << "Can't write results file '" << results_file << "'\n";
+        return 1;
+    }
+
+    return 0;
+}
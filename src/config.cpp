@@ -25,21 +25,25 @@ namespace config {
         const std::string death_royal = "data/death_royal.txt";
         const std::string scores = "scores.dat";
         std::string save_game = "game.sav";
+        const int32_t AUTOSAVE_TURNS = 1000; // Game turns between autosaves
     } // namespace files
 
     // Game options as set on startup and with `=` set options command -CJS-
     namespace options {
-        bool display_counts = true;          // Display rest/repeat counts
-        bool find_bound = false;             // Print yourself on a run (slower)
-        bool run_cut_corners = true;         // Cut corners while running
-        bool run_examine_corners = true;     // Check corners while running
-        bool run_ignore_doors = false;       // Run through open doors
-        bool run_print_self = false;         // Stop running when the map shifts
-        bool highlight_seams = false;        // Highlight magma and quartz veins
-        bool prompt_to_pickup = false;       // Prompt to pick something up
-        bool use_roguelike_keys = false;     // Use classic Roguelike keys
-        bool show_inventory_weights = false; // Display weights in inventory
-        bool error_beep_sound = true;        // Beep for invalid characters
+        thread_local bool display_counts = true;          // Display rest/repeat counts
+        thread_local bool find_bound = false;             // Print yourself on a run (slower)
+        thread_local bool run_cut_corners = true;         // Cut corners while running
+        thread_local bool run_examine_corners = true;     // Check corners while running
+        thread_local bool run_ignore_doors = false;       // Run through open doors
+        thread_local bool run_print_self = false;         // Stop running when the map shifts
+        thread_local bool highlight_seams = false;        // Highlight magma and quartz veins
+        thread_local bool prompt_to_pickup = false;       // Prompt to pick something up
+        thread_local bool use_roguelike_keys = false;     // Use classic Roguelike keys
+        thread_local bool show_inventory_weights = false; // Display weights in inventory
+        thread_local bool error_beep_sound = true;        // Beep for invalid characters
+        thread_local bool autosave = true;                // Autosave now and then, and on new levels
+        thread_local bool batch_messages = false;         // Show a turn's messages together, without -more-
+        thread_local uint8_t run_frame_rate = 30;         // Screen updates a second while running, resting or repeating, 0 for none
     } // namespace options
 
     // Dungeon generation values
@@ -87,6 +91,7 @@ namespace config {
     // Note: Number of special objects, and degree of enchantments can be adjusted here.
     namespace treasure {
         const uint8_t MIN_TREASURE_LIST_ID = 1;           // Minimum treasure_list index used
+        const uint8_t TREASURE_COMPACT_COUNT = 10;        // Objects deleted when the treasure list is full
         const uint8_t TREASURE_CHANCE_OF_GREAT_ITEM = 12; // 1/n Chance of item being a Great Item
 
         // Magic Treasure Generation constants
@@ -170,6 +175,9 @@ namespace config {
         const uint8_t MON_SUMMONED_LEVEL_ADJUST = 2;      // Adjust level of summoned creatures
         const uint8_t MON_PLAYER_EXP_DRAINED_PER_HIT = 2; // Percent of player exp drained per hit
         const uint8_t MON_MIN_INDEX_ID = 2;               // Minimum index in m_list (1 = py, 0 = no mon)
+        const uint8_t MON_COMPACT_COUNT = 10;             // Monsters deleted when the monster list is (nearly) full
+        const uint8_t MON_FAR_OFF_DISTANCE = 10;          // Beyond this, unseen monsters move in less detail
+        const uint8_t MON_FAR_OFF_TURNS = 4;              // Game turns between the moves of a far off monster
         const uint8_t SCARE_MONSTER = 99;
 
         // definitions for creatures, cmove field
@@ -24,20 +24,24 @@ namespace config {
         extern const std::string death_royal;
         extern const std::string scores;
         extern std::string save_game;
+        extern const int32_t AUTOSAVE_TURNS;
     }
 
     namespace options {
-        extern bool display_counts;
-        extern bool find_bound;
-        extern bool run_cut_corners;
-        extern bool run_examine_corners;
-        extern bool run_ignore_doors;
-        extern bool run_print_self;
-        extern bool highlight_seams;
-        extern bool prompt_to_pickup;
-        extern bool use_roguelike_keys;
-        extern bool show_inventory_weights;
-        extern bool error_beep_sound;
+        extern thread_local bool display_counts;
+        extern thread_local bool autosave;
+        extern thread_local bool find_bound;
+        extern thread_local bool run_cut_corners;
+        extern thread_local bool run_examine_corners;
+        extern thread_local bool run_ignore_doors;
+        extern thread_local bool run_print_self;
+        extern thread_local bool highlight_seams;
+        extern thread_local bool prompt_to_pickup;
+        extern thread_local bool use_roguelike_keys;
+        extern thread_local bool show_inventory_weights;
+        extern thread_local bool error_beep_sound;
+        extern thread_local bool batch_messages;
+        extern thread_local uint8_t run_frame_rate;
     }
 
     namespace dungeon {
@@ -82,6 +86,7 @@ namespace config {
 
     namespace treasure {
         extern const uint8_t MIN_TREASURE_LIST_ID;
+        extern const uint8_t TREASURE_COMPACT_COUNT;
         extern const uint8_t TREASURE_CHANCE_OF_GREAT_ITEM;
 
         extern const uint8_t LEVEL_STD_OBJECT_ADJUST;
@@ -160,6 +165,9 @@ namespace config {
         extern const uint8_t MON_SUMMONED_LEVEL_ADJUST;
         extern const uint8_t MON_PLAYER_EXP_DRAINED_PER_HIT;
         extern const uint8_t MON_MIN_INDEX_ID;
+        extern const uint8_t MON_COMPACT_COUNT;
+        extern const uint8_t MON_FAR_OFF_DISTANCE;
+        extern const uint8_t MON_FAR_OFF_TURNS;
         extern const uint8_t SCARE_MONSTER;
 
         namespace move {
@@ -11,8 +11,8 @@
 // clang-format off
 #include "headers.h"
 
-// Following are arrays for descriptive pieces
-const char *colors[MAX_COLORS] = {
+// Following are arrays for descriptive pieces, in the order each game shuffles them from
+const char *const color_names[MAX_COLORS] = {
     // Do not move the first three
     "Icky Green",  "Light Brown",  "Clear",
     "Azure", "Blue", "Blue Speckled", "Black", "Brown", "Brown Speckled", "Bubbling",
@@ -25,27 +25,27 @@ const char *colors[MAX_COLORS] = {
     "Tangerine", "Violet", "Vermilion", "White", "Yellow",
 };
 
-const char *mushrooms[MAX_MUSHROOMS] = {
+const char *const mushroom_names[MAX_MUSHROOMS] = {
     "Blue", "Black", "Black Spotted", "Brown", "Dark Blue", "Dark Green", "Dark Red",
     "Ecru", "Furry", "Green", "Grey", "Light Blue", "Light Green", "Plaid", "Red",
     "Slimy", "Tan", "White", "White Spotted", "Wooden", "Wrinkled", "Yellow",
 };
 
-const char *woods[MAX_WOODS] = {
+const char *const wood_names[MAX_WOODS] = {
     "Aspen", "Balsa", "Banyan", "Birch", "Cedar", "Cottonwood", "Cypress", "Dogwood",
     "Elm", "Eucalyptus", "Hemlock", "Hickory", "Ironwood", "Locust", "Mahogany",
     "Maple", "Mulberry", "Oak", "Pine", "Redwood", "Rosewood", "Spruce", "Sycamore",
     "Teak", "Walnut",
 };
 
-const char *metals[MAX_METALS] = {
+const char *const metal_names[MAX_METALS] = {
     "Aluminum", "Cast Iron", "Chromium", "Copper", "Gold", "Iron", "Magnesium",
     "Molybdenum", "Nickel", "Rusty", "Silver", "Steel", "Tin", "Titanium", "Tungsten",
     "Zirconium", "Zinc", "Aluminum-Plated", "Copper-Plated", "Gold-Plated",
     "Nickel-Plated", "Silver-Plated", "Steel-Plated", "Tin-Plated", "Zinc-Plated",
 };
 
-const char *rocks[MAX_ROCKS] = {
+const char *const rock_names[MAX_ROCKS] = {
     "Alexandrite", "Amethyst", "Aquamarine", "Azurite", "Beryl", "Bloodstone",
     "Calcite", "Carnelian", "Corundum", "Diamond", "Emerald", "Fluorite", "Garnet",
     "Granite", "Jade", "Jasper", "Lapis Lazuli", "Malachite", "Marble", "Moonstone",
@@ -53,7 +53,7 @@ const char *rocks[MAX_ROCKS] = {
     "Tiger Eye", "Topaz", "Turquoise", "Zircon",
 };
 
-const char *amulets[MAX_AMULETS] = {
+const char *const amulet_names[MAX_AMULETS] = {
     "Amber", "Driftwood", "Coral", "Agate", "Ivory", "Obsidian",
     "Bone", "Brass", "Bronze", "Pewter", "Tortoise Shell",
 };
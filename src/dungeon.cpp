@@ -12,7 +12,62 @@
 
 // The Dungeon global
 // Yup, this initialization is ugly, we'll fix...eventually! -MRC-
-Dungeon_t dg = Dungeon_t{0, 0, {}, -1, 0, true, {}};
+thread_local Dungeon_t dg = Dungeon_t{0, 0, {}, -1, 0, true, {}};
+
+static char caveGetCachedGlyph(Coord_t const &coord);
+
+// How much a symbol matters when folding a block of tiles into one on the map
+static int overviewPriority(char symbol) {
+    switch (symbol) {
+        case '@':
+            return 10;
+        case '<':
+        case '>':
+            return 5;
+        case '\\':
+            return -3;
+        case '#':
+            return -5;
+        case '.':
+            return -10;
+        case ' ':
+            return -15;
+        default:
+            return 0;
+    }
+}
+
+// Folds the block of tiles at `row`, `col` of the map into the symbol that matters most
+static char overviewFold(int row, int col, char (*tile_symbol)(Coord_t const &)) {
+    char symbol = ' ';
+
+    for (int y = row * RATIO; y < (row + 1) * RATIO; y++) {
+        for (int x = col * RATIO; x < (col + 1) * RATIO; x++) {
+            char tile = tile_symbol(Coord_t{y, x});
+            if (overviewPriority(symbol) < overviewPriority(tile)) {
+                symbol = tile;
+            }
+        }
+    }
+
+    return symbol;
+}
+
+// The block at `row`, `col` of the map, folded again only when out of date
+static char overviewCell(int row, int col) {
+    char &cell = dg.floor.overview[row][col];
+
+    bool stale = cell == '\0';
+    for (int y = row * RATIO; !stale && y < (row + 1) * RATIO; y++) {
+        stale = memchr(&dg.floor.glyphs[y][col * RATIO], '\0', RATIO) != nullptr;
+    }
+
+    if (stale) {
+        cell = overviewFold(row, col, caveGetCachedGlyph);
+    }
+
+    return cell;
+}
 
 // dungeonDisplayMap shrinks the dungeon to a single screen
 void dungeonDisplayMap() {
@@ -20,15 +75,6 @@ void dungeonDisplayMap() {
     terminalSaveScreen();
     clearScreen();
 
-    int16_t priority[256] = {0};
-    priority[60] = 5;   // char '<'
-    priority[62] = 5;   // char '>'
-    priority[64] = 10;  // char '@'
-    priority[35] = -5;  // char '#'
-    priority[46] = -10; // char '.'
-    priority[92] = -3;  // char '\'
-    priority[32] = -15; // char ' '
-
     // Display highest priority object in the RATIO, by RATIO area
     uint8_t panel_width = MAX_WIDTH / RATIO;
     uint8_t panel_height = MAX_HEIGHT / RATIO;
@@ -51,41 +97,33 @@ void dungeonDisplayMap() {
     addChar('+', Coord_t{panel_height + 1, panel_width + 1});
     putString("Hit any key to continue", Coord_t{23, 23});
 
+    // Blindness and hallucination change every tile, so bypass the overview
+    bool bypass_overview = (py.flags.status & config::player::status::PY_BLIND) != 0u || py.flags.image > 0;
+    bool show_player = (py.running_tracker == 0) || config::options::run_print_self;
+
     int player_y = 0;
     int player_x = 0;
-    int line = -1;
 
     // Shrink the dungeon!
-    for (uint8_t y = 0; y < MAX_HEIGHT; y++) {
-        uint8_t row = y / RATIO;
-        if (row != line) {
-            if (line >= 0) {
-                sprintf(line_buffer, "|%s|", map);
-                putString(line_buffer, Coord_t{line + 1, 0});
-            }
-            for (uint8_t j = 0; j < panel_width; j++) {
-                map[j] = ' ';
+    for (int row = 0; row < panel_height; row++) {
+        for (int col = 0; col < panel_width; col++) {
+            if (bypass_overview) {
+                map[col] = overviewFold(row, col, caveGetTileSymbol);
+            } else if (show_player && row == py.pos.y / RATIO && col == py.pos.x / RATIO) {
+                map[col] = '@';
+            } else {
+                map[col] = overviewCell(row, col);
             }
-            line = row;
-        }
 
-        for (uint8_t x = 0; x < MAX_WIDTH; x++) {
-            uint8_t col = x / RATIO;
-            char cave_char = caveGetTileSymbol(Coord_t{y, x});
-            if (priority[(uint8_t) map[col]] < priority[(uint8_t) cave_char]) {
-                map[col] = cave_char;
-            }
             if (map[col] == '@') {
                 // +1 to account for border
                 player_x = col + 1;
                 player_y = row + 1;
             }
         }
-    }
 
-    if (line >= 0) {
         sprintf(line_buffer, "|%s|", map);
-        putString(line_buffer, Coord_t{line + 1, 0});
+        putString(line_buffer, Coord_t{row + 1, 0});
     }
 
     // Move cursor onto player character
@@ -98,6 +136,107 @@ void dungeonDisplayMap() {
     terminalRestoreScreen();
 }
 
+// Sets, or clears, the flag of tiles `left` to `right` in a row of one
+// of the floor's flag planes, a whole word of tiles at a time.
+void floorFlagSetRun(uint64_t *row, int left, int right, bool value) {
+    while (left <= right) {
+        int word = left >> 6;
+        int last = right < (word << 6) + 63 ? right : (word << 6) + 63;
+        uint64_t mask = (~(uint64_t) 0 >> (63 - (last - left))) << (left & 63);
+
+        if (value) {
+            row[word] |= mask;
+        } else {
+            row[word] &= ~mask;
+        }
+
+        left = last + 1;
+    }
+}
+
+// Makes the mask of tiles `left` to `right` in row `y` with a feature id from `lowest` to `highest`
+void floorRowFeatureMask(uint64_t *mask, int y, int left, int right, uint8_t lowest, uint8_t highest) {
+    for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+        mask[word] = 0;
+    }
+
+    if (left < 0) {
+        left = 0;
+    }
+    if (right > MAX_WIDTH - 1) {
+        right = MAX_WIDTH - 1;
+    }
+
+    uint8_t const *features = dg.floor.feature_ids[y];
+
+    for (int x = left; x <= right; x++) {
+        if (features[x] >= lowest && features[x] <= highest) {
+            mask[x >> 6] |= (uint64_t) 1 << (x & 63);
+        }
+    }
+}
+
+// Adds the tiles to the left and right of every tile in the mask
+void floorRowSpread(uint64_t *mask) {
+    uint64_t spread[FLOOR_ROW_WORDS];
+
+    for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+        uint64_t before = word > 0 ? mask[word - 1] >> 63 : 0;
+        uint64_t after = word < FLOOR_ROW_WORDS - 1 ? mask[word + 1] << 63 : 0;
+
+        spread[word] = mask[word] | mask[word] << 1 | before | mask[word] >> 1 | after;
+    }
+
+    for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+        mask[word] = spread[word];
+    }
+
+    // Nothing past the edge of the floor
+    mask[FLOOR_ROW_WORDS - 1] &= ~(uint64_t) 0 >> (FLOOR_ROW_WORDS * 64 - MAX_WIDTH);
+}
+
+// The first tile at or after `x` in the mask, or MAX_WIDTH when there are no more
+int floorRowNextTile(uint64_t const *mask, int x) {
+    while (x < MAX_WIDTH) {
+        uint64_t bits = mask[x >> 6] >> (x & 63);
+
+        if (bits == 0) {
+            x = ((x >> 6) + 1) << 6;
+            continue;
+        }
+
+        while ((bits & 1) == 0) {
+            bits >>= 1;
+            x++;
+        }
+
+        return x < MAX_WIDTH ? x : MAX_WIDTH;
+    }
+
+    return MAX_WIDTH;
+}
+
+// Forgets the cached glyph of a tile, after changing its monster or object
+void floorGlyphForget(Coord_t const &coord) {
+    dg.floor.glyphs[coord.y][coord.x] = '\0';
+}
+
+// Forgets the cached glyphs of the tiles in the mask
+void floorGlyphsForget(int y, uint64_t const *mask) {
+    for (int x = floorRowNextTile(mask, 0); x < MAX_WIDTH; x = floorRowNextTile(mask, x + 1)) {
+        dg.floor.glyphs[y][x] = '\0';
+    }
+}
+
+// Forgets the cached glyphs of tiles `left` to `right` in a row
+void floorGlyphsForgetRun(int y, int left, int right) {
+    (void) memset(&dg.floor.glyphs[y][left], '\0', (size_t)(right - left + 1));
+}
+
+void floorGlyphsForgetAll() {
+    (void) memset(dg.floor.glyphs, '\0', sizeof(dg.floor.glyphs));
+}
+
 // Checks a co-ordinate for in bounds status -RAK-
 bool coordInBounds(Coord_t const &coord) {
     bool y = coord.y > 0 && coord.y < dg.height - 1;
@@ -171,21 +310,8 @@ int coordCorridorWallsNextTo(Coord_t const &coord) {
 }
 
 // Returns symbol for given row, column -RAK-
-char caveGetTileSymbol(Coord_t const &coord) {
-    Tile_t const &tile = dg.floor[coord.y][coord.x];
-
-    if (tile.creature_id == 1 && ((py.running_tracker == 0) || config::options::run_print_self)) {
-        return '@';
-    }
-
-    if ((py.flags.status & config::player::status::PY_BLIND) != 0u) {
-        return ' ';
-    }
-
-    if (py.flags.image > 0 && randomNumber(12) == 1) {
-        return (uint8_t)(randomNumber(95) + 31);
-    }
-
+// What a tile looks like, whatever the state of the player
+static char caveGetTileGlyph(Tile_t const &tile) {
     if (tile.creature_id > 1 && monsters[tile.creature_id].lit) {
         return creatures_list[monsters[tile.creature_id].creature_id].sprite;
     }
@@ -211,6 +337,35 @@ char caveGetTileSymbol(Coord_t const &coord) {
     return '%';
 }
 
+// What a tile looks like, from the glyph cache, putting its block
+// of the map out of date whenever it has to be worked out again
+static char caveGetCachedGlyph(Coord_t const &coord) {
+    char &glyph = dg.floor.glyphs[coord.y][coord.x];
+
+    if (glyph == '\0') {
+        glyph = caveGetTileGlyph(dg.floor[coord.y][coord.x]);
+        dg.floor.overview[coord.y / RATIO][coord.x / RATIO] = '\0';
+    }
+
+    return glyph;
+}
+
+char caveGetTileSymbol(Coord_t const &coord) {
+    if (dg.floor.creature_ids[coord.y][coord.x] == 1 && ((py.running_tracker == 0) || config::options::run_print_self)) {
+        return '@';
+    }
+
+    if ((py.flags.status & config::player::status::PY_BLIND) != 0u) {
+        return ' ';
+    }
+
+    if (py.flags.image > 0 && randomNumber(12) == 1) {
+        return (uint8_t)(randomNumber(95) + 31);
+    }
+
+    return caveGetCachedGlyph(coord);
+}
+
 // Tests a spot for light or field mark status -RAK-
 bool caveTileVisible(Coord_t const &coord) {
     return dg.floor[coord.y][coord.x].permanent_light || dg.floor[coord.y][coord.x].temporary_light || dg.floor[coord.y][coord.x].field_mark;
@@ -219,7 +374,7 @@ bool caveTileVisible(Coord_t const &coord) {
 // Places a particular trap at location y, x -RAK-
 void dungeonSetTrap(Coord_t const &coord, int sub_type_id) {
     int free_treasure_id = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    treasurePutOnTile(coord, free_treasure_id);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_TRAP_LIST + sub_type_id, game.treasure.list[free_treasure_id]);
 }
 
@@ -232,6 +387,7 @@ void trapChangeVisibility(Coord_t const &coord) {
 
     if (item.category_id == TV_INVIS_TRAP) {
         item.category_id = TV_VIS_TRAP;
+        floorGlyphForget(coord);
         dungeonLiteSpot(coord);
         return;
     }
@@ -241,6 +397,7 @@ void trapChangeVisibility(Coord_t const &coord) {
         item.id = config::dungeon::objects::OBJ_CLOSED_DOOR;
         item.category_id = game_objects[config::dungeon::objects::OBJ_CLOSED_DOOR].category_id;
         item.sprite = game_objects[config::dungeon::objects::OBJ_CLOSED_DOOR].sprite;
+        floorGlyphForget(coord);
         dungeonLiteSpot(coord);
     }
 }
@@ -248,8 +405,9 @@ void trapChangeVisibility(Coord_t const &coord) {
 // Places rubble at location y, x -RAK-
 void dungeonPlaceRubble(Coord_t const &coord) {
     int free_treasure_id = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    treasurePutOnTile(coord, free_treasure_id);
     dg.floor[coord.y][coord.x].feature_id = TILE_BLOCKED_FLOOR;
+    losCacheInvalidate();
     inventoryItemCopyTo(config::dungeon::objects::OBJ_RUBBLE, game.treasure.list[free_treasure_id]);
 }
 
@@ -267,7 +425,7 @@ void dungeonPlaceGold(Coord_t const &coord) {
         gold_type_id = config::dungeon::objects::MAX_GOLD_TYPES - 1;
     }
 
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    treasurePutOnTile(coord, free_treasure_id);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_GOLD_LIST + gold_type_id, game.treasure.list[free_treasure_id]);
     game.treasure.list[free_treasure_id].cost += (8L * (int32_t) randomNumber((int) game.treasure.list[free_treasure_id].cost)) + randomNumber(8);
 
@@ -280,7 +438,7 @@ void dungeonPlaceGold(Coord_t const &coord) {
 void dungeonPlaceRandomObjectAt(Coord_t const &coord, bool must_be_small) {
     int free_treasure_id = popt();
 
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    treasurePutOnTile(coord, free_treasure_id);
 
     int object_id = itemGetRandomObjectId(dg.current_level, must_be_small);
     inventoryItemCopyTo(sorted_objects[object_id], game.treasure.list[free_treasure_id]);
@@ -354,7 +512,18 @@ void dungeonPlaceRandomObjectNear(Coord_t coord, int tries) {
 void dungeonMoveCreatureRecord(Coord_t const &from, Coord_t const &to) {
     int id = dg.floor[from.y][from.x].creature_id;
     dg.floor[from.y][from.x].creature_id = 0;
-    dg.floor[to.y][to.x].creature_id = (uint8_t) id;
+    dg.floor[to.y][to.x].creature_id = (uint16_t) id;
+
+    // ID 1 is the player, who is not in the monster index
+    if (id > 1) {
+        monsterIndexMove(id, to);
+        monsterScheduleWake(id);
+    } else if (id == 1 && (std::abs(to.y - from.y) > 1 || std::abs(to.x - from.x) > 1)) {
+        // Parked monsters only allow for the player walking up to them
+        monsterScheduleWakeAll();
+    } else if (id == 1) {
+        monsterSchedulePlayerStep();
+    }
 }
 
 // Room is lit, make it appear -RAK-
@@ -370,23 +539,31 @@ void dungeonLightRoom(Coord_t const &coord) {
     Coord_t location = Coord_t{0, 0};
 
     for (location.y = top; location.y <= bottom; location.y++) {
-        for (location.x = left; location.x <= right; location.x++) {
-            Tile_t &tile = dg.floor[location.y][location.x];
+        uint64_t *permanent_lights = dg.floor.permanent_lights[location.y];
+        uint64_t lit[FLOOR_ROW_WORDS] = {};
+        floorFlagSetRun(lit, left, right, true);
+
+        // The room's tiles in this row, as the new light plane, and those that light up
+        for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+            uint64_t old_lights = permanent_lights[word];
+            permanent_lights[word] |= lit[word] & dg.floor.perma_lit_rooms[location.y][word];
+            lit[word] = permanent_lights[word] ^ old_lights;
+        }
+        floorGlyphsForget(location.y, lit);
 
-            if (tile.perma_lit_room && !tile.permanent_light) {
-                tile.permanent_light = true;
+        for (location.x = floorRowNextTile(lit, left); location.x <= right; location.x = floorRowNextTile(lit, location.x + 1)) {
+            Tile_t tile = dg.floor[location.y][location.x];
 
-                if (tile.feature_id == TILE_DARK_FLOOR) {
-                    tile.feature_id = TILE_LIGHT_FLOOR;
-                }
-                if (!tile.field_mark && tile.treasure_id != 0) {
-                    int treasure_id = game.treasure.list[tile.treasure_id].category_id;
-                    if (treasure_id >= TV_MIN_VISIBLE && treasure_id <= TV_MAX_VISIBLE) {
-                        tile.field_mark = true;
-                    }
+            if (tile.feature_id == TILE_DARK_FLOOR) {
+                tile.feature_id = TILE_LIGHT_FLOOR;
+            }
+            if (!tile.field_mark && tile.treasure_id != 0) {
+                int treasure_id = game.treasure.list[tile.treasure_id].category_id;
+                if (treasure_id >= TV_MIN_VISIBLE && treasure_id <= TV_MAX_VISIBLE) {
+                    tile.field_mark = true;
                 }
-                panelPutTile(caveGetTileSymbol(location), location);
             }
+            panelPutTile(caveGetTileSymbol(location), location);
         }
     }
 }
@@ -407,9 +584,8 @@ static void sub1MoveLight(Coord_t const &from, Coord_t const &to) {
     if (py.temporary_light_only) {
         // Turn off lamp light
         for (int y = from.y - 1; y <= from.y + 1; y++) {
-            for (int x = from.x - 1; x <= from.x + 1; x++) {
-                dg.floor[y][x].temporary_light = false;
-            }
+            floorFlagSetRun(dg.floor.temporary_lights[y], from.x - 1, from.x + 1, false);
+            floorGlyphsForgetRun(y, from.x - 1, from.x + 1);
         }
         if ((py.running_tracker != 0) && !config::options::run_print_self) {
             py.temporary_light_only = false;
@@ -419,17 +595,24 @@ static void sub1MoveLight(Coord_t const &from, Coord_t const &to) {
     }
 
     for (int y = to.y - 1; y <= to.y + 1; y++) {
-        for (int x = to.x - 1; x <= to.x + 1; x++) {
-            Tile_t &tile = dg.floor[y][x];
+        floorGlyphsForgetRun(y, to.x - 1, to.x + 1);
 
-            // only light up if normal movement
-            if (py.temporary_light_only) {
-                tile.temporary_light = true;
-            }
+        // only light up if normal movement
+        if (py.temporary_light_only) {
+            floorFlagSetRun(dg.floor.temporary_lights[y], to.x - 1, to.x + 1, true);
+        }
+
+        uint64_t walls[FLOOR_ROW_WORDS];
+        floorRowFeatureMask(walls, y, to.x - 1, to.x + 1, MIN_CAVE_WALL, UINT8_MAX);
+
+        for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+            dg.floor.permanent_lights[y][word] |= walls[word];
+        }
+
+        for (int x = to.x - 1; x <= to.x + 1; x++) {
+            Tile_t tile = dg.floor[y][x];
 
-            if (tile.feature_id >= MIN_CAVE_WALL) {
-                tile.permanent_light = true;
-            } else if (!tile.field_mark && tile.treasure_id != 0) {
+            if (tile.feature_id < MIN_CAVE_WALL && !tile.field_mark && tile.treasure_id != 0) {
                 int tval = game.treasure.list[tile.treasure_id].category_id;
 
                 if (tval >= TV_MIN_VISIBLE && tval <= TV_MAX_VISIBLE) {
@@ -504,21 +687,14 @@ void dungeonDeleteMonster(int id) {
     Monster_t *monster = &monsters[id];
 
     dg.floor[monster->pos.y][monster->pos.x].creature_id = 0;
+    monsterIndexRemove(id);
+    monsterScheduleWake(id);
 
     if (monster->lit) {
         dungeonLiteSpot(Coord_t{monster->pos.y, monster->pos.x});
     }
 
-    int last_id = next_free_monster_id - 1;
-
-    if (id != last_id) {
-        monster = &monsters[last_id];
-        dg.floor[monster->pos.y][monster->pos.x].creature_id = (uint8_t) id;
-        monsters[id] = monsters[last_id];
-    }
-
-    next_free_monster_id--;
-    monsters[next_free_monster_id] = blank_monster;
+    monsterSlotFree(id);
 
     if (monster_multiply_total > 0) {
         monster_multiply_total--;
@@ -526,14 +702,13 @@ void dungeonDeleteMonster(int id) {
 }
 
 // The following two procedures implement the same function as delete monster.
-// However, they are used within updateMonsters(), because deleting a monster
-// while scanning the monsters causes two problems, monsters might get two
-// turns, and m_ptr/monptr might be invalid after the dungeonDeleteMonster.
+// However, they are used for the monster whose turn updateMonsters() is in the
+// middle of, as its record is still in use until the turn is over. Any other
+// monster can be deleted at once, as that only frees its slot.
 // Hence the delete is done in two steps.
 //
-// dungeonDeleteMonsterFix1 does everything dungeonDeleteMonster does except delete
-// the monster record and reduce next_free_monster_id, this is called in breathe, and
-// a couple of places in creatures.c
+// dungeonDeleteMonsterFix1 does everything dungeonDeleteMonster does except free
+// the monster's slot, this is called when a monster dies by its own breath or hand
 void dungeonDeleteMonsterFix1(int id) {
     Monster_t &monster = monsters[id];
 
@@ -543,6 +718,8 @@ void dungeonDeleteMonsterFix1(int id) {
     monster.hp = -1;
 
     dg.floor[monster.pos.y][monster.pos.x].creature_id = 0;
+    monsterIndexRemove(id);
+    monsterScheduleWake(id);
 
     if (monster.lit) {
         dungeonLiteSpot(Coord_t{monster.pos.y, monster.pos.x});
@@ -556,18 +733,7 @@ void dungeonDeleteMonsterFix1(int id) {
 // dungeonDeleteMonsterFix2 does everything in dungeonDeleteMonster that wasn't done
 // by fix1_monster_delete above, this is only called in updateMonsters()
 void dungeonDeleteMonsterFix2(int id) {
-    int last_id = next_free_monster_id - 1;
-
-    if (id != last_id) {
-        int y = monsters[last_id].pos.y;
-        int x = monsters[last_id].pos.x;
-        dg.floor[y][x].creature_id = (uint8_t) id;
-
-        monsters[id] = monsters[last_id];
-    }
-
-    monsters[last_id] = blank_monster;
-    next_free_monster_id--;
+    monsterSlotFree(id);
 }
 
 // Creates objects nearby the coordinates given -RAK-
@@ -625,10 +791,11 @@ int dungeonSummonObject(Coord_t coord, int amount, int object_type) {
 
 // Deletes object from given location -RAK-
 bool dungeonDeleteObject(Coord_t const &coord) {
-    Tile_t &tile = dg.floor[coord.y][coord.x];
+    Tile_t tile = dg.floor[coord.y][coord.x];
 
     if (tile.feature_id == TILE_BLOCKED_FLOOR) {
         tile.feature_id = TILE_CORR_FLOOR;
+        losCacheInvalidate();
     }
 
     pusht(tile.treasure_id);
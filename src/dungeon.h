@@ -38,6 +38,60 @@ typedef struct {
     uint8_t depth_first_found; // Dungeon level item first found
 } DungeonObject_t;
 
+constexpr uint8_t FLOOR_ROW_WORDS = (MAX_WIDTH + 63) / 64;
+
+// The dungeon floor is kept as planes, one for each field of a tile: a byte per
+// tile for the ids (two for the creature ids), and a bit per tile, 64 to a word,
+// for each of the flags.
+// Code wanting a single field (line of sight needs just the features, lighting
+// just the light bits) can run over the plane itself; `floor[y][x]` gives the
+// Tile_t of a tile for everything else.
+//
+// `glyphs` caches what each tile looks like on screen, with '\0' for not known.
+// Changing a tile through its Tile_t forgets its glyph. Code writing straight
+// to a plane, or changing a tile's monster or object, must forget it itself.
+//
+// `overview` is the map screen: each RATIO by RATIO block of tiles folded into
+// the glyph that matters most, with '\0' for out of date. Working out a glyph
+// puts its block out of date, and so does a forgotten glyph in the block.
+typedef struct DungeonFloor_t {
+    uint16_t creature_ids[MAX_HEIGHT][MAX_WIDTH];
+    uint8_t treasure_ids[MAX_HEIGHT][MAX_WIDTH];
+    uint8_t feature_ids[MAX_HEIGHT][MAX_WIDTH];
+
+    uint64_t perma_lit_rooms[MAX_HEIGHT][FLOOR_ROW_WORDS];
+    uint64_t field_marks[MAX_HEIGHT][FLOOR_ROW_WORDS];
+    uint64_t permanent_lights[MAX_HEIGHT][FLOOR_ROW_WORDS];
+    uint64_t temporary_lights[MAX_HEIGHT][FLOOR_ROW_WORDS];
+
+    char glyphs[MAX_HEIGHT][MAX_WIDTH];
+    char overview[MAX_HEIGHT / RATIO][MAX_WIDTH / RATIO];
+
+    typedef struct {
+        DungeonFloor_t &floor;
+        int y;
+
+        Tile_t operator[](int x) const {
+            int word = x >> 6;
+            uint64_t mask = (uint64_t) 1 << (x & 63);
+
+            char &glyph = floor.glyphs[y][x];
+
+            return Tile_t{
+                TileShort_t(floor.creature_ids[y][x], glyph),
+                TileByte_t(floor.treasure_ids[y][x], glyph),
+                TileByte_t(floor.feature_ids[y][x], glyph),
+                TileFlag_t(floor.perma_lit_rooms[y][word], mask, glyph),
+                TileFlag_t(floor.field_marks[y][word], mask, glyph),
+                TileFlag_t(floor.permanent_lights[y][word], mask, glyph),
+                TileFlag_t(floor.temporary_lights[y][word], mask, glyph),
+            };
+        }
+    } Row_t;
+
+    Row_t operator[](int y) { return Row_t{*this, y}; }
+} DungeonFloor_t;
+
 typedef struct {
     // Dungeon size is either just big enough for town level, or the whole dungeon itself
     int16_t height;
@@ -55,12 +109,24 @@ typedef struct {
     bool generate_new_level;
 
     // Floor definitions
-    Tile_t floor[MAX_HEIGHT][MAX_WIDTH];
+    DungeonFloor_t floor;
 } Dungeon_t;
 
-extern Dungeon_t dg;
+extern thread_local Dungeon_t dg;
 extern DungeonObject_t game_objects[MAX_OBJECTS_IN_GAME];
 
+// Row masks: a bit per tile of a row, laid out as in the floor's flag
+// planes, so lighting can work on whole words of tiles at a time.
+void floorFlagSetRun(uint64_t *row, int left, int right, bool value);
+void floorRowFeatureMask(uint64_t *mask, int y, int left, int right, uint8_t lowest, uint8_t highest);
+void floorRowSpread(uint64_t *mask);
+int floorRowNextTile(uint64_t const *mask, int x);
+
+void floorGlyphForget(Coord_t const &coord);
+void floorGlyphsForget(int y, uint64_t const *mask);
+void floorGlyphsForgetRun(int y, int left, int right);
+void floorGlyphsForgetAll();
+
 void dungeonDisplayMap();
 
 bool coordInBounds(Coord_t const &coord);
@@ -96,4 +162,8 @@ void generateCave();
 
 // Line of Sight
 bool los(Coord_t from, Coord_t to);
+bool losFromPlayer(Coord_t const &to);
+void losCacheInvalidate();
+int flowStepsToPlayer(Coord_t const &coord);
+void flowStepsAround(Coord_t const &coord, int *steps);
 void look();
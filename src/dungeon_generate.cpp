@@ -10,8 +10,8 @@
 
 #include "headers.h"
 
-static Coord_t doors_tk[100];
-static int door_index;
+static thread_local Coord_t doors_tk[100];
+static thread_local int door_index;
 
 // Returns a Dark/Light floor tile based on dg.current_level, and random number
 static uint8_t dungeonFloorTileForLevel() {
@@ -63,7 +63,7 @@ static void chanceOfRandomDirection(int &vertical, int &horizontal) {
 
 // Blanks out entire cave -RAK-
 static void dungeonBlankEntireCave() {
-    memset((char *) &dg.floor[0][0], 0, sizeof(dg.floor));
+    memset((char *) &dg.floor, 0, sizeof(dg.floor));
 }
 
 // Fills in empty spots with desired rock -RAK-
@@ -82,47 +82,19 @@ static void dungeonFillEmptyTilesWith(uint8_t rock_type) {
     }
 }
 
-#ifdef DEBUG
-#include <assert.h>
-#endif
-
 // Places indestructible rock around edges of dungeon -RAK-
 static void dungeonPlaceBoundaryWalls() {
-    Tile_t(*left_ptr)[MAX_WIDTH];
-    Tile_t(*right_ptr)[MAX_WIDTH];
+    uint8_t(*features)[MAX_WIDTH] = dg.floor.feature_ids;
 
     // put permanent wall on leftmost row and rightmost row
-    left_ptr = (Tile_t(*)[MAX_WIDTH]) & dg.floor[0][0];
-    right_ptr = (Tile_t(*)[MAX_WIDTH]) & dg.floor[0][dg.width - 1];
-
     for (int i = 0; i < dg.height; i++) {
-#ifdef DEBUG
-        assert((Tile_t *) left_ptr == &floor[i][0]);
-        assert((Tile_t *) right_ptr == &floor[i][dg.width - 1]);
-#endif
-
-        ((Tile_t *) left_ptr)->feature_id = TILE_BOUNDARY_WALL;
-        left_ptr++;
-
-        ((Tile_t *) right_ptr)->feature_id = TILE_BOUNDARY_WALL;
-        right_ptr++;
+        features[i][0] = TILE_BOUNDARY_WALL;
+        features[i][dg.width - 1] = TILE_BOUNDARY_WALL;
     }
 
     // put permanent wall on top row and bottom row
-    Tile_t *top_ptr = &dg.floor[0][0];
-    Tile_t *bottom_ptr = &dg.floor[dg.height - 1][0];
-
-    for (int i = 0; i < dg.width; i++) {
-#ifdef DEBUG
-        assert(top_ptr == &floor[0][i]);
-        assert(bottom_ptr == &floor[dg.height - 1][i]);
-#endif
-        top_ptr->feature_id = TILE_BOUNDARY_WALL;
-        top_ptr++;
-
-        bottom_ptr->feature_id = TILE_BOUNDARY_WALL;
-        bottom_ptr++;
-    }
+    (void) memset(features[0], TILE_BOUNDARY_WALL, (size_t) dg.width);
+    (void) memset(features[dg.height - 1], TILE_BOUNDARY_WALL, (size_t) dg.width);
 }
 
 // Places "streamers" of rock through dungeon -RAK-
@@ -165,14 +137,14 @@ static void dungeonPlaceStreamerRock(uint8_t rock_type, int chance_of_treasure)
 
 static void dungeonPlaceOpenDoor(Coord_t coord) {
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_OPEN_DOOR, game.treasure.list[cur_pos]);
     dg.floor[coord.y][coord.x].feature_id = TILE_CORR_FLOOR;
 }
 
 static void dungeonPlaceBrokenDoor(Coord_t coord) {
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_OPEN_DOOR, game.treasure.list[cur_pos]);
     dg.floor[coord.y][coord.x].feature_id = TILE_CORR_FLOOR;
     game.treasure.list[cur_pos].misc_use = 1;
@@ -180,14 +152,14 @@ static void dungeonPlaceBrokenDoor(Coord_t coord) {
 
 static void dungeonPlaceClosedDoor(Coord_t coord) {
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, game.treasure.list[cur_pos]);
     dg.floor[coord.y][coord.x].feature_id = TILE_BLOCKED_FLOOR;
 }
 
 static void dungeonPlaceLockedDoor(Coord_t coord) {
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, game.treasure.list[cur_pos]);
     dg.floor[coord.y][coord.x].feature_id = TILE_BLOCKED_FLOOR;
     game.treasure.list[cur_pos].misc_use = (int16_t)(randomNumber(10) + 10);
@@ -195,7 +167,7 @@ static void dungeonPlaceLockedDoor(Coord_t coord) {
 
 static void dungeonPlaceStuckDoor(Coord_t coord) {
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, game.treasure.list[cur_pos]);
     dg.floor[coord.y][coord.x].feature_id = TILE_BLOCKED_FLOOR;
     game.treasure.list[cur_pos].misc_use = (int16_t)(-randomNumber(10) - 10);
@@ -203,7 +175,7 @@ static void dungeonPlaceStuckDoor(Coord_t coord) {
 
 static void dungeonPlaceSecretDoor(Coord_t coord) {
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_SECRET_DOOR, game.treasure.list[cur_pos]);
     dg.floor[coord.y][coord.x].feature_id = TILE_BLOCKED_FLOOR;
 }
@@ -239,7 +211,7 @@ static void dungeonPlaceUpStairs(Coord_t coord) {
     }
 
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_UP_STAIR, game.treasure.list[cur_pos]);
 }
 
@@ -250,7 +222,7 @@ static void dungeonPlaceDownStairs(Coord_t coord) {
     }
 
     int cur_pos = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(coord, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_DOWN_STAIR, game.treasure.list[cur_pos]);
 }
 
@@ -330,6 +302,14 @@ static void dungeonPlaceVaultMonster(Coord_t coord, int number) {
     }
 }
 
+// Lays the floor of a room, a row of the floor planes at a time
+static void dungeonFillRoomFloor(int height, int depth, int left, int right, uint8_t floor) {
+    for (int y = height; y <= depth; y++) {
+        (void) memset(&dg.floor.feature_ids[y][left], floor, (size_t)(right - left + 1));
+        floorFlagSetRun(dg.floor.perma_lit_rooms[y], left, right, true);
+    }
+}
+
 // Builds a room at a row, column coordinate -RAK-
 static void dungeonBuildRoom(Coord_t coord) {
     uint8_t floor = dungeonFloorTileForLevel();
@@ -344,12 +324,7 @@ static void dungeonBuildRoom(Coord_t coord) {
 
     int y, x;
 
-    for (y = height; y <= depth; y++) {
-        for (x = left; x <= right; x++) {
-            dg.floor[y][x].feature_id = floor;
-            dg.floor[y][x].perma_lit_room = true;
-        }
-    }
+    dungeonFillRoomFloor(height, depth, left, right, floor);
 
     for (y = height - 1; y <= depth + 1; y++) {
         dg.floor[y][left - 1].feature_id = TILE_GRANITE_WALL;
@@ -386,12 +361,7 @@ static void dungeonBuildRoomOverlappingRectangles(Coord_t coord) {
 
         int y, x;
 
-        for (y = height; y <= depth; y++) {
-            for (x = left; x <= right; x++) {
-                dg.floor[y][x].feature_id = floor;
-                dg.floor[y][x].perma_lit_room = true;
-            }
-        }
+        dungeonFillRoomFloor(height, depth, left, right, floor);
         for (y = (height - 1); y <= (depth + 1); y++) {
             if (dg.floor[y][left - 1].feature_id != floor) {
                 dg.floor[y][left - 1].feature_id = TILE_GRANITE_WALL;
@@ -548,12 +518,7 @@ static void dungeonBuildRoomWithInnerRooms(Coord_t coord) {
     // the x dim of rooms tends to be much larger than the y dim,
     // so don't bother rewriting the y loop.
 
-    for (int i = height; i <= depth; i++) {
-        for (int j = left; j <= right; j++) {
-            dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
-        }
-    }
+    dungeonFillRoomFloor(height, depth, left, right, floor);
 
     for (int i = (height - 1); i <= (depth + 1); i++) {
         dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
@@ -689,12 +654,7 @@ static void dungeonBuildRoomCrossShaped(Coord_t coord) {
     int left = coord.x - 1;
     int right = coord.x + 1;
 
-    for (int i = height; i <= depth; i++) {
-        for (int j = left; j <= right; j++) {
-            dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
-        }
-    }
+    dungeonFillRoomFloor(height, depth, left, right, floor);
 
     for (int i = height - 1; i <= depth + 1; i++) {
         dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
@@ -719,12 +679,7 @@ static void dungeonBuildRoomCrossShaped(Coord_t coord) {
     left = coord.x - random_offset;
     right = coord.x + random_offset;
 
-    for (int i = height; i <= depth; i++) {
-        for (int j = left; j <= right; j++) {
-            dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
-        }
-    }
+    dungeonFillRoomFloor(height, depth, left, right, floor);
 
     for (int i = height - 1; i <= depth + 1; i++) {
         if (dg.floor[i][left - 1].feature_id != floor) {
@@ -935,7 +890,7 @@ static void dungeonBuildTunnel(Coord_t start, Coord_t end) {
     }
 
     for (int i = 0; i < wall_index; i++) {
-        Tile_t &tile = dg.floor[walls_tk[i].y][walls_tk[i].x];
+        Tile_t tile = dg.floor[walls_tk[i].y][walls_tk[i].x];
 
         if (tile.feature_id == TMP2_WALL) {
             if (randomNumber(100) < config::dungeon::DUN_ROOM_DOORS) {
@@ -968,14 +923,12 @@ static void dungeonPlaceDoorIfNextToTwoWalls(Coord_t coord) {
 
 // Returns random co-ordinates -RAK-
 static void dungeonNewSpot(Coord_t &coord) {
-    Tile_t *tile = nullptr;
     Coord_t position = Coord_t{0, 0};
 
     do {
         position.y = (int32_t) randomNumber(dg.height - 2);
         position.x = (int32_t) randomNumber(dg.width - 2);
-        tile = &dg.floor[position.y][position.x];
-    } while (tile->feature_id >= MIN_CLOSED_SPACE || tile->creature_id != 0 || tile->treasure_id != 0);
+    } while (dg.floor.feature_ids[position.y][position.x] >= MIN_CLOSED_SPACE || dg.floor.creature_ids[position.y][position.x] != 0 || dg.floor.treasure_ids[position.y][position.x] != 0);
 
     coord.y = position.y;
     coord.x = position.x;
@@ -1146,7 +1099,7 @@ static void dungeonBuildStore(int store_id, Coord_t coord) {
     dg.floor[y][x].feature_id = TILE_CORR_FLOOR;
 
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    treasurePutOnTile(Coord_t{y, x}, cur_pos);
 
     inventoryItemCopyTo(config::dungeon::objects::OBJ_STORE_DOOR + store_id, game.treasure.list[cur_pos]);
 }
@@ -1164,7 +1117,9 @@ static void monsterLinker() {
     for (auto &monster : monsters) {
         monster = blank_monster;
     }
-    next_free_monster_id = config::monsters::MON_MIN_INDEX_ID;
+    monsterSlotsClear();
+    monsterIndexClear();
+    monsterScheduleClear();
 }
 
 static void dungeonPlaceTownStores() {
@@ -1207,9 +1162,7 @@ static void lightTown() {
     } else {
         // ...it is day time
         for (int y = 0; y < dg.height; y++) {
-            for (int x = 0; x < dg.width; x++) {
-                dg.floor[y][x].permanent_light = true;
-            }
+            floorFlagSetRun(dg.floor.permanent_lights[y], 0, dg.width - 1, true);
         }
         monsterPlaceNewWithinDistance(config::monsters::MON_MIN_TOWNSFOLK_DAY, 3, true);
     }
@@ -1257,6 +1210,7 @@ void generateCave() {
     treasureLinker();
     monsterLinker();
     dungeonBlankEntireCave();
+    losCacheInvalidate();
 
     // We're in the dungeon more than the town, so let's default to that -MRC-
     dg.height = MAX_HEIGHT;
@@ -1278,4 +1232,7 @@ void generateCave() {
     } else {
         dungeonGenerate();
     }
+
+    // Generation writes straight to the floor planes
+    floorGlyphsForgetAll();
 }
@@ -43,7 +43,7 @@ bool los(Coord_t from, Coord_t to) {
         }
 
         for (int yy = from.y + 1; yy < to.y; yy++) {
-            if (dg.floor[yy][from.x].feature_id >= MIN_CLOSED_SPACE) {
+            if (dg.floor.feature_ids[yy][from.x] >= MIN_CLOSED_SPACE) {
                 return false;
             }
         }
@@ -59,7 +59,7 @@ bool los(Coord_t from, Coord_t to) {
         }
 
         for (int xx = from.x + 1; xx < to.x; xx++) {
-            if (dg.floor[from.y][xx].feature_id >= MIN_CLOSED_SPACE) {
+            if (dg.floor.feature_ids[from.y][xx] >= MIN_CLOSED_SPACE) {
                 return false;
             }
         }
@@ -112,7 +112,7 @@ bool los(Coord_t from, Coord_t to) {
             }
 
             while ((to.x - xx) != 0) {
-                if (dg.floor[yy][xx].feature_id >= MIN_CLOSED_SPACE) {
+                if (dg.floor.feature_ids[yy][xx] >= MIN_CLOSED_SPACE) {
                     return false;
                 }
 
@@ -122,7 +122,7 @@ bool los(Coord_t from, Coord_t to) {
                     xx += x_sign;
                 } else if (dy > scale_half) {
                     yy += y_sign;
-                    if (dg.floor[yy][xx].feature_id >= MIN_CLOSED_SPACE) {
+                    if (dg.floor.feature_ids[yy][xx] >= MIN_CLOSED_SPACE) {
                         return false;
                     }
                     xx += x_sign;
@@ -153,7 +153,7 @@ bool los(Coord_t from, Coord_t to) {
         }
 
         while ((to.y - yy) != 0) {
-            if (dg.floor[yy][xx].feature_id >= MIN_CLOSED_SPACE) {
+            if (dg.floor.feature_ids[yy][xx] >= MIN_CLOSED_SPACE) {
                 return false;
             }
 
@@ -163,7 +163,7 @@ bool los(Coord_t from, Coord_t to) {
                 yy += y_sign;
             } else if (dx > scale_half) {
                 xx += x_sign;
-                if (dg.floor[yy][xx].feature_id >= MIN_CLOSED_SPACE) {
+                if (dg.floor.feature_ids[yy][xx] >= MIN_CLOSED_SPACE) {
                     return false;
                 }
                 yy += y_sign;
@@ -178,6 +178,169 @@ bool los(Coord_t from, Coord_t to) {
     }
 }
 
+// los() results from the player's position are cached for the tiles around them,
+// as every monster in sight asks for one each turn. The cache is thrown away when
+// the player moves, and must be invalidated when a tile changes between blocking
+// and not blocking the view (doors, tunnelling, walls built or destroyed).
+// Bumping the generation makes every cached result stale, without clearing them.
+constexpr int LOS_CACHE_RADIUS = 20; // covers the MON_MAX_SIGHT distance
+constexpr int LOS_CACHE_SIZE = LOS_CACHE_RADIUS * 2 + 1;
+
+static thread_local uint32_t los_cache_generation;
+static thread_local Coord_t los_cache_origin;
+static thread_local uint32_t los_cache_stamps[LOS_CACHE_SIZE][LOS_CACHE_SIZE];
+static thread_local bool los_cache_visible[LOS_CACHE_SIZE][LOS_CACHE_SIZE];
+
+// Counts the changes to the terrain, for the flow field below
+static thread_local uint32_t terrain_generation;
+
+static void losCacheClear() {
+    los_cache_generation++;
+
+    if (los_cache_generation == 0) {
+        for (auto &row : los_cache_stamps) {
+            for (auto &stamp : row) {
+                stamp = 0;
+            }
+        }
+        los_cache_generation = 1;
+    }
+}
+
+void losCacheInvalidate() {
+    terrain_generation++;
+    losCacheClear();
+}
+
+// Same as los(py.pos, to), but looked up in the cache when `to` is near the player.
+bool losFromPlayer(Coord_t const &to) {
+    int row = to.y - py.pos.y + LOS_CACHE_RADIUS;
+    int col = to.x - py.pos.x + LOS_CACHE_RADIUS;
+
+    if (row < 0 || row >= LOS_CACHE_SIZE || col < 0 || col >= LOS_CACHE_SIZE) {
+        return los(py.pos, to);
+    }
+
+    if (los_cache_generation == 0 || los_cache_origin.y != py.pos.y || los_cache_origin.x != py.pos.x) {
+        losCacheClear();
+        los_cache_origin = py.pos;
+    }
+
+    if (los_cache_stamps[row][col] != los_cache_generation) {
+        los_cache_visible[row][col] = los(py.pos, to);
+        los_cache_stamps[row][col] = los_cache_generation;
+    }
+
+    return los_cache_visible[row][col];
+}
+
+// The flow field is how many steps it is to walk from each tile to the player,
+// out to FLOW_MAX_STEPS, with doors counted as open, so chasing monsters can
+// follow the corridors rather than walk into walls. It is worked out again,
+// with a breadth first search, only when asked for after the player has moved
+// or the terrain changed, as told by losCacheInvalidate().
+static const int FLOW_MAX_STEPS = config::monsters::MON_MAX_SIGHT; // as far as monsters can see
+constexpr uint8_t FLOW_UNREACHED = UINT8_MAX;
+
+static thread_local uint8_t flow_steps[MAX_HEIGHT][MAX_WIDTH];
+static thread_local uint16_t flow_queue[MAX_HEIGHT * MAX_WIDTH]; // the tiles reached, by steps
+static thread_local int flow_reached;
+static thread_local Coord_t flow_origin;
+static thread_local uint32_t flow_generation; // terrain_generation it was worked out for
+static thread_local bool flow_ready;
+
+static bool flowCanWalk(int y, int x) {
+    if (dg.floor.feature_ids[y][x] <= MAX_OPEN_SPACE) {
+        return true;
+    }
+
+    uint8_t treasure_id = dg.floor.treasure_ids[y][x];
+    if (treasure_id == 0) {
+        return false;
+    }
+
+    uint8_t category_id = game.treasure.list[treasure_id].category_id;
+    return category_id == TV_CLOSED_DOOR || category_id == TV_SECRET_DOOR;
+}
+
+static void flowFromPlayer() {
+    if (!flow_ready) {
+        (void) memset(flow_steps, FLOW_UNREACHED, sizeof(flow_steps));
+    } else {
+        // Only the tiles reached last time need clearing
+        for (int i = 0; i < flow_reached; i++) {
+            flow_steps[flow_queue[i] / MAX_WIDTH][flow_queue[i] % MAX_WIDTH] = FLOW_UNREACHED;
+        }
+    }
+
+    int head = 0;
+    int tail = 0;
+
+    flow_steps[py.pos.y][py.pos.x] = 0;
+    flow_queue[tail++] = (uint16_t)(py.pos.y * MAX_WIDTH + py.pos.x);
+
+    while (head < tail) {
+        int y = flow_queue[head] / MAX_WIDTH;
+        int x = flow_queue[head] % MAX_WIDTH;
+        head++;
+
+        int steps = flow_steps[y][x] + 1;
+        if (steps > FLOW_MAX_STEPS) {
+            break;
+        }
+
+        // The outer walls are never walkable, so a neighbour can't be off the map
+        for (int ny = y - 1; ny <= y + 1; ny++) {
+            for (int nx = x - 1; nx <= x + 1; nx++) {
+                if (flow_steps[ny][nx] != FLOW_UNREACHED || !flowCanWalk(ny, nx)) {
+                    continue;
+                }
+
+                flow_steps[ny][nx] = (uint8_t) steps;
+                flow_queue[tail++] = (uint16_t)(ny * MAX_WIDTH + nx);
+            }
+        }
+    }
+
+    flow_reached = tail;
+    flow_origin = py.pos;
+    flow_generation = terrain_generation;
+    flow_ready = true;
+}
+
+// Steps from `coord` to the player, or -1 when further than the flow field reaches
+int flowStepsToPlayer(Coord_t const &coord) {
+    if (!flow_ready || flow_generation != terrain_generation || flow_origin.y != py.pos.y || flow_origin.x != py.pos.x) {
+        flowFromPlayer();
+    }
+
+    uint8_t steps = flow_steps[coord.y][coord.x];
+    return steps == FLOW_UNREACHED ? -1 : steps;
+}
+
+// Fills `steps` with the steps to the player from each tile around `coord`,
+// indexed by keypad direction with 5 being `coord` itself, -1 for those further
+// than the flow field reaches. One look up for the lot, where a monster weighing
+// up its moves would otherwise ask for every tile in turn.
+void flowStepsAround(Coord_t const &coord, int *steps) {
+    steps[5] = flowStepsToPlayer(coord);
+
+    for (int dir = 1; dir <= 9; dir++) {
+        if (dir == 5) {
+            continue;
+        }
+
+        int y = coord.y - (dir - 1) / 3 + 1;
+        int x = coord.x + (dir - 1) % 3 - 1;
+
+        if (y < 0 || y >= MAX_HEIGHT || x < 0 || x >= MAX_WIDTH || flow_steps[y][x] == FLOW_UNREACHED) {
+            steps[dir] = -1;
+        } else {
+            steps[dir] = flow_steps[y][x];
+        }
+    }
+}
+
 /*
   An enhanced look, with peripheral vision. Looking all 8 -CJS- directions will
   see everything which ought to be visible. Can specify direction 5, which looks
@@ -227,10 +390,10 @@ bool los(Coord_t from, Coord_t to) {
   dungeon y = py.pos.y + los_fyx * (ray x) + los_fyy * (ray y)
   dungeon x = py.pos.x + los_fxx * (ray x) + los_fxy * (ray y)
 */
-static int los_fxx, los_fxy, los_fyx, los_fyy;
-static int los_num_places_seen;
-static bool los_hack_no_query;
-static int los_rocks_and_objects;
+static thread_local int los_fxx, los_fxy, los_fyx, los_fyy;
+static thread_local int los_num_places_seen;
+static thread_local bool los_hack_no_query;
+static thread_local int los_rocks_and_objects;
 
 // Intended to be indexed by dir/2, since is only
 // relevant to horizontal or vertical directions.
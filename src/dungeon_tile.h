@@ -8,16 +8,73 @@
 
 #pragma once
 
-// Tile_t holds data about a specific tile in the dungeon.
+// TileId_t is one of a tile's ids in a plane of the dungeon floor, and
+// reads and assigns like the `uint8_t` or `uint16_t` it stands for.
+// Assigning it also forgets the tile's cached glyph.
+template <typename T>
+class TileId_t {
+public:
+    TileId_t(T &plane_id, char &tile_glyph) : id(plane_id), glyph(tile_glyph) {}
+    TileId_t(TileId_t const &) = default;
+
+    operator T() const { return id; }
+
+    TileId_t &operator=(T value) {
+        id = value;
+        glyph = '\0';
+        return *this;
+    }
+
+    TileId_t &operator=(TileId_t const &value) { return *this = (T) value; }
+
+private:
+    T &id;
+    char &glyph;
+};
+
+typedef TileId_t<uint8_t> TileByte_t;
+typedef TileId_t<uint16_t> TileShort_t; // monster ids, as there can be more than 255
+
+// TileFlag_t is one tile's bit in a flag plane of the dungeon floor,
+// and reads and assigns just like the `bool` it stands for. Assigning
+// it also forgets the tile's cached glyph.
+class TileFlag_t {
+public:
+    TileFlag_t(uint64_t &plane_word, uint64_t tile_mask, char &tile_glyph) : word(plane_word), mask(tile_mask), glyph(tile_glyph) {}
+    TileFlag_t(TileFlag_t const &) = default;
+
+    operator bool() const { return (word & mask) != 0; }
+
+    TileFlag_t &operator=(bool value) {
+        if (value) {
+            word |= mask;
+        } else {
+            word &= ~mask;
+        }
+        glyph = '\0';
+        return *this;
+    }
+
+    TileFlag_t &operator=(TileFlag_t const &flag) { return *this = (bool) flag; }
+
+private:
+    uint64_t &word;
+    uint64_t mask;
+    char &glyph;
+};
+
+// Tile_t holds data about a specific tile in the dungeon. The floor keeps
+// each field in a plane of its own (see DungeonFloor_t), so a Tile_t refers
+// to its fields there, and is passed around by value.
 typedef struct {
-    uint8_t creature_id; // ID for any creature occupying the tile
-    uint8_t treasure_id; // ID for any treasure item occupying the tile
-    uint8_t feature_id;  // ID of cave feature; walls, floors, open space, etc.
-
-    bool perma_lit_room : 1;  // Room should be lit with perm light, walls with this set should be perm lit after tunneled out.
-    bool field_mark : 1;      // Field mark, used for traps/doors/stairs, object is hidden if fm is false.
-    bool permanent_light : 1; // Permanent light, used for walls and lighted rooms.
-    bool temporary_light : 1; // Temporary light, used for player's lamp light,etc.
+    TileShort_t creature_id; // ID for any creature occupying the tile
+    TileByte_t treasure_id; // ID for any treasure item occupying the tile
+    TileByte_t feature_id;  // ID of cave feature; walls, floors, open space, etc.
+
+    TileFlag_t perma_lit_room;  // Room should be lit with perm light, walls with this set should be perm lit after tunneled out.
+    TileFlag_t field_mark;      // Field mark, used for traps/doors/stairs, object is hidden if fm is false.
+    TileFlag_t permanent_light; // Permanent light, used for walls and lighted rooms.
+    TileFlag_t temporary_light; // Temporary light, used for player's lamp light,etc.
 } Tile_t;
 
 // `fval` definitions: these describe the various types of dungeon floors and
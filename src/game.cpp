@@ -11,10 +11,22 @@
 #include "headers.h"
 #include "version.h"
 
+#include <chrono>
+
 // holds the previous rnd state
-static uint32_t old_seed;
+static thread_local uint32_t old_seed;
+
+// When, and on which turn, the dungeon loop started. Used for
+// the turns per second report at the end of a headless game.
+static thread_local std::chrono::steady_clock::time_point simulation_start_time;
+static thread_local int32_t simulation_start_turn;
+
+// Saving the game ends it, and forgets its turn, so the timing stops there
+static thread_local bool simulation_stopped = false;
+static thread_local std::chrono::steady_clock::time_point simulation_stop_time;
+static thread_local int32_t simulation_stop_turn;
 
-Game_t game = Game_t{};
+thread_local Game_t game = Game_t{};
 
 // gets a new random seed for the random number generator
 void seedsInitialize(uint32_t seed) {
@@ -133,6 +145,8 @@ static struct {
     {"Highlight and notice mineral seams", &config::options::highlight_seams},
     {"Beep for invalid character", &config::options::error_beep_sound},
     {"Display rest/repeat counts", &config::options::display_counts},
+    {"Autosave every so often and on new levels", &config::options::autosave},
+    {"Batch a turn's messages, no -more-", &config::options::batch_messages},
     {nullptr, nullptr},
 };
 
@@ -154,6 +168,8 @@ void setGameOptions() {
 
         switch (getKeyInput()) {
             case ESCAPE:
+                // Seams may look different now
+                floorGlyphsForgetAll();
                 return;
             case '-':
                 if (option_id > 0) {
@@ -324,15 +340,58 @@ bool getAllDirections(const char *prompt, int &direction) {
     }
 }
 
+// Start timing the game turns, for the headless simulation report
+void simulationTimerStart() {
+    simulation_start_time = std::chrono::steady_clock::now();
+    simulation_start_turn = dg.game_turn;
+}
+
+// Stop timing the game turns, as the game is about to be saved
+void simulationTimerStop() {
+    if (simulation_stopped) {
+        return;
+    }
+
+    simulation_stop_time = std::chrono::steady_clock::now();
+    simulation_stop_turn = dg.game_turn;
+    simulation_stopped = true;
+}
+
+// Game turns played since simulationTimerStart()
+int32_t simulationTurns() {
+    if (simulation_start_time.time_since_epoch().count() == 0) {
+        return 0;
+    }
+    return (simulation_stopped ? simulation_stop_turn : dg.game_turn) - simulation_start_turn;
+}
+
+// Wall clock seconds since simulationTimerStart()
+double simulationSeconds() {
+    if (simulation_start_time.time_since_epoch().count() == 0) {
+        return 0;
+    }
+
+    auto now = simulation_stopped ? simulation_stop_time : std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed = now - simulation_start_time;
+    return elapsed.count();
+}
+
 // Restore the terminal and exit
 void exitProgram() {
+    (void) autosaveWait();
     flushInputBuffer();
     terminalRestore();
+
+    if (terminalIsHeadless()) {
+        throw GameExit_t{};
+    }
     exit(0);
 }
 
 // Abort the program with a message displayed on the terminal.
 void abortProgram(const char *msg) {
+    (void) autosaveWait();
     flushInputBuffer();
     terminalRestore();
 
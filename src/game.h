@@ -49,17 +49,30 @@ typedef struct {
 
     vtype_t character_died_from = {'\0'}; // What the character died from: starvation, Bat, etc.
 
+    struct {
+        int32_t objects = 0;  // Times the treasure list had to be compacted
+        int32_t monsters = 0; // Times the monster list had to be compacted
+    } compactions;
+
     struct {
         int16_t current_id = 0; // Current treasure heap ptr
         Inventory_t list[LEVEL_MAX_OBJECTS]{};
+        Coord_t locations[LEVEL_MAX_OBJECTS]{}; // Tile each record was last put on, for pusht()
     } treasure;
 } Game_t;
 
-extern Game_t game;
+// All the state of a game is `thread_local`, so every thread can play its
+// own independent game. This is what `umoria-batch` uses to run its games.
+extern thread_local Game_t game;
+
+// Thrown by exitProgram() in headless mode, so the caller of startMoria()
+// gets control back, rather than the whole process exiting.
+typedef struct {
+} GameExit_t;
 
-extern int16_t sorted_objects[MAX_DUNGEON_OBJECTS];
+extern thread_local int16_t sorted_objects[MAX_DUNGEON_OBJECTS];
 extern uint16_t normal_table[NORMAL_TABLE_SIZE];
-extern int16_t treasure_levels[TREASURE_MAX_LEVELS + 1];
+extern thread_local int16_t treasure_levels[TREASURE_MAX_LEVELS + 1];
 
 void seedsInitialize(uint32_t seed);
 void seedSet(uint32_t seed);
@@ -76,10 +89,15 @@ bool getAllDirections(const char *prompt, int &direction);
 
 void exitProgram();
 void abortProgram(const char *msg);
+void simulationTimerStart();
+void simulationTimerStop();
+int32_t simulationTurns();
+double simulationSeconds();
 
 // game object management
 int popt();
 void pusht(uint8_t treasure_id);
+void treasurePutOnTile(Coord_t const &coord, int treasure_id);
 int itemGetRandomObjectId(int level, bool must_be_small);
 
 // game files
@@ -89,12 +107,15 @@ void displayTextHelpFile(const std::string &filename);
 void displayDeathFile(const std::string &filename);
 void outputRandomLevelObjectsToFile();
 bool outputPlayerCharacterToFile(char *filename);
+bool outputMessageLogToFile(char *filename);
 
 // game death
 void endGame();
 
 // save/load
 bool saveGame();
+void autosaveGame();
+bool autosaveWait();
 bool loadGame(bool &generate);
 void setFileptr(FILE *file);
 
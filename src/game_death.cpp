@@ -123,6 +123,12 @@ static void kingly() {
 // What happens upon dying -RAK-
 // Handles the gravestone and top-twenty routines -RAK-
 void endGame() {
+    // A headless game has nobody to show the tomb to, and simulation
+    // runs should neither save the character nor touch the score file.
+    if (terminalIsHeadless()) {
+        exitProgram();
+    }
+
     printMessage(CNIL);
 
     // flush all input
@@ -361,8 +361,9 @@ static void writeInventoryToFile(FILE *inv_file) {
     (void) fprintf(inv_file, "%c", CTRL_KEY('L'));
 }
 
-// Print the character to a file or device -RAK-
-bool outputPlayerCharacterToFile(char *filename) {
+// Opens a file to write to, asking before replacing an existing one.
+// Returns nullptr, having said so, when it can't be opened.
+static FILE *openOutputFile(char *filename) {
     int fd = open(filename, O_WRONLY | O_CREAT | O_EXCL, 0644);
     if (fd < 0 && errno == EEXIST) {
         if (getInputConfirmation("Replace existing file " + std::string(filename) + "?")) {
@@ -387,6 +388,15 @@ bool outputPlayerCharacterToFile(char *filename) {
         vtype_t msg = {'\0'};
         (void) sprintf(msg, "Can't open file %s:", filename);
         printMessage(msg);
+    }
+
+    return file;
+}
+
+// Print the character to a file or device -RAK-
+bool outputPlayerCharacterToFile(char *filename) {
+    FILE *file = openOutputFile(filename);
+    if (file == nullptr) {
         return false;
     }
 
@@ -400,3 +410,21 @@ bool outputPlayerCharacterToFile(char *filename) {
 
     return true;
 }
+
+// Write the message log to a file, oldest message first
+bool outputMessageLogToFile(char *filename) {
+    FILE *file = openOutputFile(filename);
+    if (file == nullptr) {
+        return false;
+    }
+
+    for (int age = messageLogCount() - 1; age >= 0; age--) {
+        (void) fprintf(file, "%s\n", messageLogEntry(age));
+    }
+
+    (void) fclose(file);
+
+    putStringClearToEOL("Completed.", Coord_t{0, 0});
+
+    return true;
+}
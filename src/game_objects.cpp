@@ -10,61 +10,89 @@
 
 #include "headers.h"
 
-int16_t sorted_objects[MAX_DUNGEON_OBJECTS];
-int16_t treasure_levels[TREASURE_MAX_LEVELS + 1];
+#include <algorithm>
+
+thread_local int16_t sorted_objects[MAX_DUNGEON_OBJECTS];
+thread_local int16_t treasure_levels[TREASURE_MAX_LEVELS + 1];
+
+// How reluctant compaction is to delete an object, -1 when it never may
+static int compactionReluctance(Inventory_t const &item) {
+    switch (item.category_id) {
+        case TV_UP_STAIR:
+        case TV_DOWN_STAIR:
+        case TV_STORE_DOOR:
+            // Stairs, don't delete them.
+            // Shop doors, don't delete them.
+            return -1;
+        case TV_INVIS_TRAP:
+        case TV_RUBBLE:
+        case TV_OPEN_DOOR:
+        case TV_CLOSED_DOOR:
+        case TV_SECRET_DOOR:
+            // Hidden traps, doors and rubble are part of the level, so take them last.
+            return 1;
+        default:
+            return 0;
+    }
+}
 
 // If too many objects on floor level, delete some of them-RAK-
+// Deletes the TREASURE_COMPACT_COUNT objects furthest from the player,
+// taking doors and rubble only when there is nothing else.
 static void compactObjects() {
     printMessage("Compacting objects...");
 
-    int counter = 0;
-    int current_distance = 66;
-
-    Coord_t coord = Coord_t{0, 0};
-
-    while (counter <= 0) {
-        for (coord.y = 0; coord.y < dg.height; coord.y++) {
-            for (coord.x = 0; coord.x < dg.width; coord.x++) {
-                if (dg.floor[coord.y][coord.x].treasure_id != 0 && coordDistanceBetween(coord, py.pos) > current_distance) {
-                    int chance;
-
-                    switch (game.treasure.list[dg.floor[coord.y][coord.x].treasure_id].category_id) {
-                        case TV_VIS_TRAP:
-                            chance = 15;
-                            break;
-                        case TV_INVIS_TRAP:
-                        case TV_RUBBLE:
-                        case TV_OPEN_DOOR:
-                        case TV_CLOSED_DOOR:
-                            chance = 5;
-                            break;
-                        case TV_UP_STAIR:
-                        case TV_DOWN_STAIR:
-                        case TV_STORE_DOOR:
-                            // Stairs, don't delete them.
-                            // Shop doors, don't delete them.
-                            chance = 0;
-                            break;
-                        case TV_SECRET_DOOR: // secret doors
-                            chance = 3;
-                            break;
-                        default:
-                            chance = 10;
-                    }
-                    if (randomNumber(100) <= chance) {
-                        (void) dungeonDeleteObject(coord);
-                        counter++;
-                    }
-                }
-            }
+    game.compactions.objects++;
+
+    int reluctance[LEVEL_MAX_OBJECTS];
+    int distances[LEVEL_MAX_OBJECTS];
+    int16_t candidates[LEVEL_MAX_OBJECTS];
+    int count = 0;
+
+    for (int id = config::treasure::MIN_TREASURE_LIST_ID; id < game.treasure.current_id; id++) {
+        Coord_t const &coord = game.treasure.locations[id];
+
+        // Only the objects lying in the dungeon can be compacted
+        if (dg.floor[coord.y][coord.x].treasure_id != id) {
+            continue;
         }
 
-        if (counter == 0) {
-            current_distance -= 6;
+        reluctance[id] = compactionReluctance(game.treasure.list[id]);
+        if (reluctance[id] < 0) {
+            continue;
         }
+
+        distances[id] = coordDistanceBetween(coord, py.pos);
+        candidates[count++] = (int16_t) id;
     }
 
-    if (current_distance < 66) {
+    auto keep_longer = [&reluctance, &distances](int16_t a, int16_t b) {
+        if (reluctance[a] != reluctance[b]) {
+            return reluctance[a] > reluctance[b];
+        }
+        if (distances[a] != distances[b]) {
+            return distances[a] < distances[b];
+        }
+        return a < b;
+    };
+
+    std::make_heap(candidates, candidates + count, keep_longer);
+
+    // pusht() renumbers the objects as they go, so remember them by location.
+    Coord_t victims[LEVEL_MAX_OBJECTS];
+    int total = 0;
+
+    while (total < config::treasure::TREASURE_COMPACT_COUNT && count > 0) {
+        std::pop_heap(candidates, candidates + count, keep_longer);
+        count--;
+        victims[total++] = game.treasure.locations[candidates[count]];
+    }
+
+    for (int i = 0; i < total; i++) {
+        (void) dungeonDeleteObject(victims[i]);
+    }
+
+    if (total > 0) {
         drawDungeonPanel();
     }
 }
@@ -78,18 +106,35 @@ int popt() {
     return game.treasure.current_id++;
 }
 
+// Puts the treasure record on the tile, remembering where it went
+void treasurePutOnTile(Coord_t const &coord, int treasure_id) {
+    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) treasure_id;
+    game.treasure.locations[treasure_id] = coord;
+}
+
 // Pushes a record back onto free space list -RAK-
 // `dungeonDeleteObject()` should always be called instead, unless the object
 // in question is not in the dungeon, e.g. in store1.c and files.c
 void pusht(uint8_t treasure_id) {
-    if (treasure_id != game.treasure.current_id - 1) {
-        game.treasure.list[treasure_id] = game.treasure.list[game.treasure.current_id - 1];
-
-        // must change the treasure_id in the cave of the object just moved
-        for (int y = 0; y < dg.height; y++) {
-            for (int x = 0; x < dg.width; x++) {
-                if (dg.floor[y][x].treasure_id == game.treasure.current_id - 1) {
-                    dg.floor[y][x].treasure_id = treasure_id;
+    int last_id = game.treasure.current_id - 1;
+
+    if (treasure_id != last_id) {
+        game.treasure.list[treasure_id] = game.treasure.list[last_id];
+
+        // must change the treasure_id in the cave of the object just moved.
+        // No other tile can hold its id, so if the one it was last put on
+        // still does, that's the one. Otherwise (say, the object is not in
+        // the dungeon) fall back to looking through the whole cave.
+        Coord_t const &coord = game.treasure.locations[last_id];
+
+        if (dg.floor[coord.y][coord.x].treasure_id == last_id) {
+            treasurePutOnTile(coord, treasure_id);
+        } else {
+            for (int y = 0; y < dg.height; y++) {
+                for (int x = 0; x < dg.width; x++) {
+                    if (dg.floor[y][x].treasure_id == last_id) {
+                        treasurePutOnTile(Coord_t{y, x}, treasure_id);
+                    }
                 }
             }
         }
@@ -132,6 +132,8 @@ void startMoria(int seed, bool start_new_game) {
         generateCave();
     }
 
+    simulationTimerStart();
+
     // Loop till dead, or exit
     while (!game.character_is_dead) {
         // Dungeon logic
@@ -152,6 +154,7 @@ void startMoria(int seed, bool start_new_game) {
         // New level if not dead
         if (!game.character_is_dead) {
             generateCave();
+            autosaveGame();
         }
     }
 
@@ -236,13 +239,17 @@ static void initializeTreasureLevels() {
 }
 
 // Adjust prices of objects -RAK-
+// Note: `game_objects` is shared by all threads, so it must only be written when
+// there is something to adjust. A `constexpr` is not visible to an `#if`.
 static void priceAdjust() {
-#if (COST_ADJUSTMENT != 100)
+    if (COST_ADJUSTMENT == 100) {
+        return;
+    }
+
     // round half-way cases up
     for (auto &item : game_objects) {
         item.cost = ((item.cost * COST_ADJUSTMENT) + 50) / 100;
     }
-#endif
 }
 
 // Moria game module -RAK-
@@ -449,7 +456,8 @@ static int playerFoodConsumption() {
     return regen_amount;
 }
 
-static void playerUpdateRegeneration(int amount) {
+// The regeneration rate for a turn, from the one the player's food allows
+static int playerRegenerationPercent(int amount) {
     if (py.flags.regenerate_hp) {
         amount = amount * 3 / 2;
     }
@@ -458,6 +466,12 @@ static void playerUpdateRegeneration(int amount) {
         amount = amount * 2;
     }
 
+    return amount;
+}
+
+static void playerUpdateRegeneration(int amount) {
+    amount = playerRegenerationPercent(amount);
+
     if (py.flags.poisoned < 1 && py.misc.current_hp < py.misc.max_hp) {
         playerRegenerateHitPoints(amount);
     }
@@ -885,6 +899,15 @@ static void playerUpdateWordOfRecall() {
     }
 }
 
+// The timed effects are all zero on nearly every turn, so a turn
+// checks them together once, and only then runs their updaters.
+static bool playerTimedEffectsActive() {
+    return (py.flags.blind | py.flags.confused | py.flags.afraid | py.flags.poisoned | py.flags.fast | py.flags.slow |     //
+            py.flags.image | py.flags.paralysis | py.flags.protect_evil | py.flags.invulnerability | py.flags.blessed | //
+            py.flags.heat_resistance | py.flags.cold_resistance | py.flags.detect_invisible | py.flags.timed_infra |     //
+            py.flags.word_of_recall) != 0;
+}
+
 static void playerUpdateStatusFlags() {
     if ((py.flags.status & config::player::status::PY_SPEED) != 0u) {
         py.flags.status &= ~config::player::status::PY_SPEED;
@@ -951,6 +974,208 @@ static void playerDetectEnchantment() {
     }
 }
 
+// The 1 in x chance of the detect enchantment roll made every 16 turns -CJS-
+// for 1st level char, check once every 2160 turns
+// for 40th level char, check once every 416 turns
+static int playerDetectEnchantmentChance() {
+    return 10 + 750 / (5 + py.misc.level);
+}
+
+// Turns a timed effect can be counted down in one go, short of the turn it
+// starts or runs out on. `status` is its flag, if it has one, which is set
+// on the turn it starts.
+static int playerTimedEffectTurns(int16_t counter, uint32_t status) {
+    if (counter <= 0) {
+        return SHRT_MAX;
+    }
+
+    if (status != 0 && (py.flags.status & status) == 0) {
+        return 0;
+    }
+
+    return counter - 1;
+}
+
+static void playerTimedEffectCountDown(int16_t &counter, int turns) {
+    if (counter > 0) {
+        counter = (int16_t) (counter - turns);
+    }
+}
+
+// Turns of regeneration at `per_turn` 2^16ths a turn before `current` is full, 0 when it is
+static int32_t playerRegenerationTurnsToFull(int16_t current, uint16_t fraction, int16_t maximum, int32_t per_turn) {
+    if (current >= maximum) {
+        return 0;
+    }
+
+    int64_t needed = ((int64_t) maximum << 16) - (((int64_t) current << 16) + fraction);
+
+    return (int32_t) ((needed + per_turn - 1) / per_turn);
+}
+
+// Regenerates hit points or mana for `turns` turns at once, coming out where
+// that many calls of playerRegenerateHitPoints() or playerRegenerateMana() would
+static void playerRegenerateTurns(int16_t &current, uint16_t &fraction, int16_t maximum, int32_t per_turn, int turns) {
+    int64_t total = ((int64_t) current << 16) + fraction + (int64_t) per_turn * turns;
+
+    if (total >= ((int64_t) maximum << 16)) {
+        current = maximum;
+        fraction = 0;
+    } else {
+        current = (int16_t) (total >> 16);
+        fraction = (uint16_t) (total & 0xFFFF);
+    }
+}
+
+// Turns of a rest that can be played in one go: ones on which nothing can
+// happen but counters going down, hit points and mana coming back, and
+// random rolls that come up empty. 0 when the turns have to be played one
+// by one, as with monsters awake nearby, or the light burning low.
+static int playerRestTurnsToSkip() {
+    if (py.flags.rest == 0 || game.character_is_dead || dg.generate_new_level || game.teleport_player) {
+        return 0;
+    }
+
+    // These do something on every turn they last
+    if ((py.flags.blind | py.flags.confused | py.flags.afraid | py.flags.poisoned | py.flags.image | py.flags.paralysis) != 0) {
+        return 0;
+    }
+
+    if ((py.flags.status & config::player::status::PY_STR_WGT) != 0u || monsterSlotsLeft() < 10) {
+        return 0;
+    }
+
+    // The last turn of the rest is left to playerUpdateRestingState()
+    int turns = py.flags.rest > 0 ? py.flags.rest - 1 : -py.flags.rest - 1;
+
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.heroism, config::player::status::PY_HERO));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.super_heroism, config::player::status::PY_SHERO));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.fast, config::player::status::PY_FAST));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.slow, config::player::status::PY_SLOW));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.protect_evil, 0));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.invulnerability, config::player::status::PY_INVULN));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.blessed, config::player::status::PY_BLESSED));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.heat_resistance, 0));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.cold_resistance, 0));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.detect_invisible, config::player::status::PY_DET_INV));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.timed_infra, config::player::status::PY_TIM_INFRA));
+    turns = std::min(turns, playerTimedEffectTurns(py.flags.word_of_recall, 0));
+
+    // A light under 40 turns rolls for growing faint, see playerUpdateLightStatus()
+    int light = py.inventory[PlayerEquipment::Light].misc_use;
+
+    if (py.carrying_light) {
+        turns = std::min(turns, light - 40);
+    } else if (light > 0) {
+        return 0;
+    }
+
+    // Food is checked against the next hunger level before it is eaten
+    int food_eaten = py.flags.food_digested + (py.flags.speed < 0 ? py.flags.speed * py.flags.speed : 0);
+    int food_left = py.flags.food - ((py.flags.status & config::player::status::PY_HUNGRY) != 0u ? config::player::PLAYER_FOOD_WEAK : config::player::PLAYER_FOOD_ALERT);
+
+    if (food_left < 0) {
+        return 0;
+    }
+    if (food_eaten > 0) {
+        turns = std::min(turns, food_left / food_eaten + 1);
+    }
+
+    // Resting until done stops on the turn both are full
+    if (py.flags.rest < 0) {
+        int percent = playerRegenerationPercent(config::player::PLAYER_REGEN_NORMAL);
+        int32_t hp_turns = playerRegenerationTurnsToFull(py.misc.current_hp, py.misc.current_hp_fraction, py.misc.max_hp,
+                                                         (int32_t) py.misc.max_hp * percent + config::player::PLAYER_REGEN_HPBASE);
+        int32_t mana_turns = playerRegenerationTurnsToFull(py.misc.current_mana, py.misc.current_mana_fraction, py.misc.mana,
+                                                           (int32_t) py.misc.mana * percent + config::player::PLAYER_REGEN_MNBASE);
+
+        turns = std::min(turns, (int) std::max(hp_turns, mana_turns) - 1);
+    }
+
+    if (turns <= 0) {
+        return 0;
+    }
+
+    return monstersRestTurns(turns);
+}
+
+// Plays the turns of a rest on which nothing can happen in one step, rather
+// than a whole playDungeon() turn for each. The random rolls of those turns
+// (new monsters, random teleports, detect enchantment) are made as they would
+// be, and the skip stops just short of the first one to come up, or of a store
+// maintenance or autosave turn, so the game goes on exactly as it would have.
+static void playerRestFastForward() {
+    int turns_left = playerRestTurnsToSkip();
+    int turns = 0;
+    int chance = playerDetectEnchantmentChance();
+
+    while (turns < turns_left) {
+        int32_t turn = dg.game_turn + turns + 1;
+
+        if ((dg.current_level != 0 && turn % 1000 == 0) || turn % config::files::AUTOSAVE_TURNS == 0) {
+            break;
+        }
+
+        uint32_t seed = getRandomSeed();
+
+        bool rolled = randomNumber(config::monsters::MON_CHANCE_OF_NEW) == 1;
+        rolled = rolled || (py.flags.teleport && randomNumber(100) == 1);
+        rolled = rolled || ((turn & 0xF) == 0 && randomNumber(chance) == 1);
+
+        if (rolled) {
+            // Taken back for the turn itself to roll again, setRandomSeed() adds the 1
+            setRandomSeed(seed - 1);
+            break;
+        }
+
+        turns++;
+    }
+
+    if (turns == 0) {
+        return;
+    }
+
+    monstersRest(turns);
+    dg.game_turn += turns;
+
+    if (py.carrying_light) {
+        Inventory_t &item = py.inventory[PlayerEquipment::Light];
+        item.misc_use = (int16_t) (item.misc_use - turns);
+    }
+
+    playerTimedEffectCountDown(py.flags.heroism, turns);
+    playerTimedEffectCountDown(py.flags.super_heroism, turns);
+    playerTimedEffectCountDown(py.flags.fast, turns);
+    playerTimedEffectCountDown(py.flags.slow, turns);
+    playerTimedEffectCountDown(py.flags.protect_evil, turns);
+    playerTimedEffectCountDown(py.flags.invulnerability, turns);
+    playerTimedEffectCountDown(py.flags.blessed, turns);
+    playerTimedEffectCountDown(py.flags.heat_resistance, turns);
+    playerTimedEffectCountDown(py.flags.cold_resistance, turns);
+    playerTimedEffectCountDown(py.flags.detect_invisible, turns);
+    playerTimedEffectCountDown(py.flags.timed_infra, turns);
+    playerTimedEffectCountDown(py.flags.word_of_recall, turns);
+
+    int food_eaten = py.flags.food_digested + (py.flags.speed < 0 ? py.flags.speed * py.flags.speed : 0);
+    py.flags.food = (int16_t) (py.flags.food - food_eaten * turns);
+
+    int percent = playerRegenerationPercent(config::player::PLAYER_REGEN_NORMAL);
+
+    if (py.misc.current_hp < py.misc.max_hp) {
+        playerRegenerateTurns(py.misc.current_hp, py.misc.current_hp_fraction, py.misc.max_hp,
+                              (int32_t) py.misc.max_hp * percent + config::player::PLAYER_REGEN_HPBASE, turns);
+        printCharacterCurrentHitPoints();
+    }
+
+    if (py.misc.current_mana < py.misc.mana) {
+        playerRegenerateTurns(py.misc.current_mana, py.misc.current_mana_fraction, py.misc.mana,
+                              (int32_t) py.misc.mana * percent + config::player::PLAYER_REGEN_MNBASE, turns);
+        printCharacterCurrentMana();
+    }
+
+    py.flags.rest = (int16_t) (py.flags.rest > 0 ? py.flags.rest - turns : py.flags.rest + turns);
+}
+
 static int getCommandRepeatCount(char &last_input_command) {
     putStringClearToEOL("Repeat count:", Coord_t{0, 0});
 
@@ -1037,7 +1262,7 @@ static void executeInputCommands(char &command, int &find_count) {
                 playerEndRunning();
             }
 
-            putQIO();
+            putQIOFrame();
             continue;
         }
 
@@ -1054,7 +1279,7 @@ static void executeInputCommands(char &command, int &find_count) {
         if (game.command_count > 0) {
             game.use_last_direction = true;
         } else {
-            last_input_command = getKeyInput();
+            last_input_command = getCommandKeyInput();
 
             // Get a count for a command.
             int repeat_count = 0;
@@ -1087,10 +1312,14 @@ static void executeInputCommands(char &command, int &find_count) {
             }
         }
 
-        // Flash the message line.
+        // Flash the message line, once a frame when repeating a command.
         messageLineClear();
         panelMoveCursor(py.pos);
-        putQIO();
+        if (game.command_count > 0) {
+            putQIOFrame();
+        } else {
+            putQIO();
+        }
 
         doCommand(last_input_command);
 
@@ -1419,29 +1648,32 @@ static void commandPreviousMessage() {
     if (max_messages <= 1) {
         // Distinguish real and recovered messages with a '>'. -CJS-
         putString(">", Coord_t{0, 0});
-        putStringClearToEOL(messages[last_message_id], Coord_t{0, 1});
+        putStringClearToEOL(messageLogEntry(0), Coord_t{0, 1});
         return;
     }
 
     terminalSaveScreen();
 
     uint8_t line_number = max_messages;
-    int16_t msg_id = last_message_id;
 
-    while (max_messages > 0) {
-        max_messages--;
+    for (int age = 0; age < line_number; age++) {
+        putStringClearToEOL(messageLogEntry(age), Coord_t{line_number - 1 - age, 0});
+    }
 
-        putStringClearToEOL(messages[msg_id], Coord_t{max_messages, 0});
+    // The whole log, not just what fits on screen, can be filed from here.
+    eraseLine(Coord_t{line_number, 0});
+    putStringClearToEOL("[ <f>ile the message log, any other key to continue ]", Coord_t{line_number, 13});
 
-        if (msg_id == 0) {
-            msg_id = MESSAGE_HISTORY_SIZE - 1;
-        } else {
-            msg_id--;
+    if (getKeyInput() == 'f') {
+        vtype_t filename = {'\0'};
+        putStringClearToEOL("File name:", Coord_t{line_number, 0});
+
+        if (getStringInput(filename, Coord_t{line_number, 11}, 60) && filename[0] != 0) {
+            (void) outputMessageLogToFile(filename);
+            waitForContinueKey(line_number);
         }
     }
 
-    eraseLine(Coord_t{line_number, 0});
-    waitForContinueKey(line_number);
     terminalRestoreScreen();
 }
 
@@ -2317,6 +2549,9 @@ static void playDungeon() {
     // Loop until dead,  or new level
     // Exit when `dg.generate_new_level` and `eof_flag` are both set
     do {
+        // Resting with no monster awake skips ahead to the next turn something can happen on
+        playerRestFastForward();
+
         // Increment turn counter
         dg.game_turn++;
 
@@ -2325,6 +2560,10 @@ static void playDungeon() {
             storeMaintenance();
         }
 
+        if (dg.game_turn % config::files::AUTOSAVE_TURNS == 0) {
+            autosaveGame();
+        }
+
         // Check for creature generation
         if (randomNumber(config::monsters::MON_CHANCE_OF_NEW) == 1) {
             monsterPlaceNewWithinDistance(1, config::monsters::MON_MAX_SIGHT, false);
@@ -2342,29 +2581,35 @@ static void playDungeon() {
         int regen_amount = playerFoodConsumption();
         playerUpdateRegeneration(regen_amount);
 
-        playerUpdateBlindness();
-        playerUpdateConfusion();
-        playerUpdateFearState();
-        playerUpdatePoisonedState();
-        playerUpdateSpeed();
+        // Nothing until the interrupt check can start another of them
+        bool timed_effects = playerTimedEffectsActive();
+
+        if (timed_effects) {
+            playerUpdateBlindness();
+            playerUpdateConfusion();
+            playerUpdateFearState();
+            playerUpdatePoisonedState();
+            playerUpdateSpeed();
+        }
         playerUpdateRestingState();
 
         // Check for interrupts to find or rest.
-        int microseconds = (py.running_tracker != 0 ? 0 : 10000);
-        if ((game.command_count > 0 || (py.running_tracker != 0) || py.flags.rest != 0) && checkForNonBlockingKeyPress(microseconds)) {
+        if ((game.command_count > 0 || (py.running_tracker != 0) || py.flags.rest != 0) && checkForNonBlockingKeyPress()) {
             playerDisturb(0, 0);
         }
 
-        playerUpdateHallucination();
-        playerUpdateParalysis();
-        playerUpdateEvilProtection();
-        playerUpdateInvulnerability();
-        playerUpdateBlessedness();
-        playerUpdateHeatResistance();
-        playerUpdateColdResistance();
-        playerUpdateDetectInvisible();
-        playerUpdateInfraVision();
-        playerUpdateWordOfRecall();
+        if (timed_effects) {
+            playerUpdateHallucination();
+            playerUpdateParalysis();
+            playerUpdateEvilProtection();
+            playerUpdateInvulnerability();
+            playerUpdateBlessedness();
+            playerUpdateHeatResistance();
+            playerUpdateColdResistance();
+            playerUpdateDetectInvisible();
+            playerUpdateInfraVision();
+            playerUpdateWordOfRecall();
+        }
 
         // Random teleportation
         if (py.flags.teleport && randomNumber(100) == 1) {
@@ -2384,10 +2629,7 @@ static void playDungeon() {
         playerUpdateStatusFlags();
 
         // Allow for a slim chance of detect enchantment -CJS-
-        // for 1st level char, check once every 2160 turns
-        // for 40th level char, check once every 416 turns
-        int chance = 10 + 750 / (5 + py.misc.level);
-        if ((dg.game_turn & 0xF) == 0 && py.flags.confused == 0 && randomNumber(chance) == 1) {
+        if ((dg.game_turn & 0xF) == 0 && py.flags.confused == 0 && randomNumber(playerDetectEnchantmentChance()) == 1) {
             playerDetectEnchantment();
         }
 
@@ -2396,7 +2638,7 @@ static void playDungeon() {
         // creature.c when monsters try to multiply.  Compact_monsters() is
         // much more likely to succeed if called from here, than if called
         // from within updateMonsters().
-        if (MON_TOTAL_ALLOCATIONS - next_free_monster_id < 10) {
+        if (monsterSlotsLeft() < 10) {
             (void) compactMonsters();
         }
 
@@ -2404,10 +2646,10 @@ static void playDungeon() {
         if (py.flags.paralysis < 1 && py.flags.rest == 0 && !game.character_is_dead) {
             executeInputCommands(last_input_command, find_count);
         } else {
-            // if paralyzed, resting, or dead, flush output
+            // if paralyzed, resting, or dead, flush output once a frame
             // but first move the cursor onto the player, for aesthetics
             panelMoveCursor(py.pos);
-            putQIO();
+            putQIOFrame();
         }
 
         // Teleport?
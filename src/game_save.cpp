@@ -11,7 +11,10 @@
 #include "headers.h"
 #include "version.h"
 
+#include <atomic>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 // For debugging the save file code on systems with broken compilers.
 #define DEBUG(x)
@@ -32,6 +35,7 @@ static void wrShorts(uint16_t *value, int count);
 static void wrItem(Inventory_t &item);
 static void wrMonster(Monster_t const &monster);
 
+static void putByte(uint8_t value);
 static uint8_t getByte();
 
 static bool rdBool();
@@ -46,10 +50,36 @@ static void rdItem(Inventory_t &item);
 static void rdMonster(Monster_t &monster);
 
 // these are used for the save file, to avoid having to pass them to every procedure
-static FILE *fileptr;
-static uint8_t xor_byte;
-static int from_save_file;   // can overwrite old save file when save
-static uint32_t start_time; // time that play started
+static thread_local FILE *fileptr;
+static thread_local uint8_t xor_byte;
+static thread_local int from_save_file;   // can overwrite old save file when save
+static thread_local uint32_t start_time; // time that play started
+
+// Save games are put together in memory and written with a single write(),
+// to a temporary file which then replaces the old save file. The game data
+// (still xor'ed, as ever) follows a header with its length and a CRC-32.
+// Save files without the header are from older versions, and the whole file
+// is the game data. Either way it's all read into memory before parsing.
+// The score file still goes through `fileptr`.
+//
+// Format 2 has 16-bit monster ids on the tiles, and marks the free slots of
+// the monster list. Format 1 files, and older, still load.
+static const uint8_t SAVE_FILE_MAGIC[4] = {'U', 'M', 'S', 'V'};
+constexpr uint8_t SAVE_FILE_FORMAT = 2;
+constexpr size_t SAVE_FILE_HEADER_SIZE = 13; // magic, format, data length, CRC-32
+
+static thread_local bool save_buffered = false;
+static thread_local std::vector<uint8_t> save_buffer;
+static thread_local const uint8_t *load_data = nullptr;
+static thread_local size_t load_size = 0;
+static thread_local size_t load_position = 0;
+static thread_local uint8_t load_format = 0; // 0 for a file without the header
+
+// Autosaves are serialized into memory by the game, which is quick, and
+// then written by a thread of their own so play never waits on the disk.
+static thread_local std::thread autosave_writer;
+static thread_local std::atomic<bool> autosave_finished(true);
+static thread_local bool autosave_ok = true; // set by the writer, before it finishes
 
 // This save package was brought to by                -JWT-
 // and                                                -RAK-
@@ -57,6 +87,17 @@ static uint32_t start_time; // time that play started
 // and has been completely rewritten again by         -CJS-
 // and completely rewritten again! for portability by -JEW-
 
+// Headless games are simulations and journal replays, which must not touch
+// anyone's save file. Every file operation asks journalOutcome() how it went,
+// so a replay goes the way the recorded game did, and others as if it worked.
+static bool saveFileExists(const std::string &filename) {
+    return journalOutcome(!terminalIsHeadless() && access(filename.c_str(), 0) == 0);
+}
+
+static bool saveFileRemove(const std::string &filename) {
+    return journalOutcome(terminalIsHeadless() || unlink(filename.c_str()) == 0);
+}
+
 // Set up prior to actual save, do the save, then clean up
 bool saveGame() {
     vtype_t input = {'\0'};
@@ -67,7 +108,7 @@ bool saveGame() {
         printMessage(output.c_str());
 
         int i = 0;
-        if (access(config::files::save_game.c_str(), 0) < 0 || !getInputConfirmation("File exists. Delete old save file?") || (i = unlink(config::files::save_game.c_str())) < 0) {
+        if (!saveFileExists(config::files::save_game) || !getInputConfirmation("File exists. Delete old save file?") || (i = saveFileRemove(config::files::save_game) ? 0 : -1) < 0) {
             if (i < 0) {
                 output = "Can't delete '" + config::files::save_game + "'";
                 printMessage(output.c_str());
@@ -97,6 +138,11 @@ static bool svWrite() {
 
     uint32_t l = 0;
 
+    // Stored inverted, so that autosave is on for characters from older versions
+    if (!config::options::autosave) {
+        l |= 0x800;
+    }
+
     if (config::options::run_cut_corners) {
         l |= 0x1;
     }
@@ -130,6 +176,9 @@ static bool svWrite() {
     if (config::options::display_counts) {
         l |= 0x400;
     }
+    if (config::options::batch_messages) {
+        l |= 0x1000;
+    }
     if (game.character_is_dead) {
         // Sign bit
         l |= 0x80000000L;
@@ -267,8 +316,12 @@ static bool svWrite() {
     wrBytes(objects_identified, OBJECT_IDENT_SIZE);
     wrLong(game.magic_seed);
     wrLong(game.town_seed);
-    wrShort((uint16_t) last_message_id);
-    for (auto &message : messages) {
+
+    // Save files keep the newest messages of the log, oldest first.
+    wrShort(MESSAGE_HISTORY_SIZE - 1);
+    for (int age = MESSAGE_HISTORY_SIZE - 1; age >= 0; age--) {
+        vtype_t message = {'\0'};
+        (void) snprintf(message, sizeof(message), "%s", messageLogEntry(age));
         wrString(message);
     }
 
@@ -314,7 +367,7 @@ static bool svWrite() {
     // only level specific info follows, this allows characters to be
     // resurrected, the dungeon level info is not needed for a resurrection
     if (game.character_is_dead) {
-        return !((ferror(fileptr) != 0) || fflush(fileptr) == EOF);
+        return true;
     }
 
     wrShort((uint16_t) dg.current_level);
@@ -331,7 +384,7 @@ static bool svWrite() {
             if (dg.floor[i][j].creature_id != 0) {
                 wrByte((uint8_t) i);
                 wrByte((uint8_t) j);
-                wrByte(dg.floor[i][j].creature_id);
+                wrShort(dg.floor[i][j].creature_id);
             }
         }
     }
@@ -356,9 +409,17 @@ static bool svWrite() {
     int count = 0;
     uint8_t prev_char = 0;
 
-    for (auto &row : dg.floor) {
-        for (auto tile : row) {
-            auto char_tmp = (uint8_t)(tile.feature_id | (tile.perma_lit_room << 4) | (tile.field_mark << 5) | (tile.permanent_light << 6) | (tile.temporary_light << 7));
+    // The flags are packed back into the feature byte, straight from the floor planes
+    for (int y = 0; y < MAX_HEIGHT; y++) {
+        for (int x = 0; x < MAX_WIDTH; x++) {
+            int word = x >> 6;
+            int bit = x & 63;
+
+            auto char_tmp = (uint8_t)(dg.floor.feature_ids[y][x] |                          //
+                                      ((dg.floor.perma_lit_rooms[y][word] >> bit) & 1) << 4 |  //
+                                      ((dg.floor.field_marks[y][word] >> bit) & 1) << 5 |      //
+                                      ((dg.floor.permanent_lights[y][word] >> bit) & 1) << 6 | //
+                                      ((dg.floor.temporary_lights[y][word] >> bit) & 1) << 7);
 
             if (char_tmp != prev_char || count == UCHAR_MAX) {
                 wrByte((uint8_t) count);
@@ -381,10 +442,156 @@ static bool svWrite() {
     }
     wrShort((uint16_t) next_free_monster_id);
     for (int i = config::monsters::MON_MIN_INDEX_ID; i < next_free_monster_id; i++) {
-        wrMonster(monsters[i]);
+        bool free = monsterSlotIsFree(i);
+        wrBool(free);
+        if (!free) {
+            wrMonster(monsters[i]);
+        }
     }
 
-    return !((ferror(fileptr) != 0) || fflush(fileptr) == EOF);
+    return true;
+}
+
+// CRC-32 (as used by zip and PNG) of the save game data
+static uint32_t saveFileChecksum(const uint8_t *data, size_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
+
+static void putLittleEndian(uint8_t *bytes, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t getLittleEndian(const uint8_t *bytes) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+// Fills in the header reserved at the front of `buffer`, writes it all to
+// a temporary file, and only then puts that in place of the old save file.
+static bool writeSaveFile(const std::string &filename, std::vector<uint8_t> &buffer) {
+    uint8_t *header = buffer.data();
+    auto data_size = (uint32_t)(buffer.size() - SAVE_FILE_HEADER_SIZE);
+
+    (void) memcpy(header, SAVE_FILE_MAGIC, sizeof(SAVE_FILE_MAGIC));
+    header[4] = SAVE_FILE_FORMAT;
+    putLittleEndian(header + 5, data_size);
+    putLittleEndian(header + 9, saveFileChecksum(header + SAVE_FILE_HEADER_SIZE, data_size));
+
+    std::string temp_filename = filename + ".new";
+
+#ifdef _WIN32
+    int fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0600);
+#else
+    int fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+#endif
+    if (fd < 0) {
+        return false;
+    }
+
+    auto written = write(fd, buffer.data(), (unsigned int) buffer.size());
+    bool ok = written >= 0 && (size_t) written == buffer.size();
+
+#ifdef _WIN32
+    ok = ok && _commit(fd) == 0;
+#else
+    ok = ok && fsync(fd) == 0;
+#endif
+    ok = close(fd) == 0 && ok;
+
+    if (ok && rename(temp_filename.c_str(), filename.c_str()) != 0) {
+        // Windows won't rename over an existing file
+        (void) unlink(filename.c_str());
+        ok = rename(temp_filename.c_str(), filename.c_str()) == 0;
+    }
+
+    if (!ok) {
+        (void) unlink(temp_filename.c_str());
+    }
+
+    return ok;
+}
+
+// Reads the whole save file into `data`, and points the loader at the game data in it.
+static bool readSaveFile(const std::string &filename, std::vector<uint8_t> &data) {
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool ok = fseek(file, 0, SEEK_END) == 0;
+    long size = ok ? ftell(file) : -1;
+    ok = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+
+    if (ok) {
+        data.resize((size_t) size);
+        ok = fread(data.data(), 1, data.size(), file) == data.size();
+    }
+
+    if (fclose(file) != 0 || !ok) {
+        return false;
+    }
+
+    load_data = data.data();
+    load_size = data.size();
+    load_position = 0;
+    load_format = 0;
+
+    if (load_size < sizeof(SAVE_FILE_MAGIC) || memcmp(load_data, SAVE_FILE_MAGIC, sizeof(SAVE_FILE_MAGIC)) != 0) {
+        return true; // an older save file, without a header
+    }
+
+    if (load_size < SAVE_FILE_HEADER_SIZE || load_data[4] < 1 || load_data[4] > SAVE_FILE_FORMAT) {
+        return false;
+    }
+    load_format = load_data[4];
+
+    uint32_t data_size = getLittleEndian(load_data + 5);
+    uint32_t checksum = getLittleEndian(load_data + 9);
+
+    load_data += SAVE_FILE_HEADER_SIZE;
+    load_size -= SAVE_FILE_HEADER_SIZE;
+
+    return data_size == load_size && checksum == saveFileChecksum(load_data, load_size);
+}
+
+// Serializes the game into `save_buffer`, leaving room for the header in front
+static bool saveToBuffer(uint8_t xor_seed) {
+    // Parked monsters have their distances from the player saved up to date
+    monsterScheduleWakeAll();
+
+    save_buffer.assign(SAVE_FILE_HEADER_SIZE, 0);
+    save_buffered = true;
+
+    xor_byte = 0;
+    wrByte(CURRENT_VERSION_MAJOR);
+    xor_byte = 0;
+    wrByte(CURRENT_VERSION_MINOR);
+    xor_byte = 0;
+    wrByte(CURRENT_VERSION_PATCH);
+    xor_byte = 0;
+
+    wrByte(xor_seed);
+    // Note that xor_byte is now equal to xor_seed
+
+    bool ok = svWrite();
+
+    save_buffered = false;
+
+    return ok;
 }
 
 static bool saveChar(const std::string &filename) {
@@ -392,58 +599,46 @@ static bool saveChar(const std::string &filename) {
         return true; // Nothing to save.
     }
 
+    // Both use the same temporary file
+    (void) autosaveWait();
+
     putQIO();
     playerDisturb(1, 0);                   // Turn off resting and searching.
     playerChangeSpeed(-py.pack.heaviness); // Fix the speed
     py.pack.heaviness = 0;
     bool ok = false;
 
-    fileptr = nullptr; // Do not assume it has been init'ed
+    bool headless = terminalIsHeadless();
 
-    int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    int fd = headless ? -1 : open(filename.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool created = journalOutcome(headless || fd >= 0);
 
-    if (fd < 0 && access(filename.c_str(), 0) >= 0 && ((from_save_file != 0) || (game.wizard_mode && getInputConfirmation("Can't make new save file. Overwrite old?")))) {
-        (void) chmod(filename.c_str(), 0600);
-        fd = open(filename.c_str(), O_RDWR | O_TRUNC, 0600);
-    }
+    // The old save file is only replaced once the new one is safely written
+    bool can_write = created || (saveFileExists(filename) && ((from_save_file != 0) || (game.wizard_mode && getInputConfirmation("Can't make new save file. Overwrite old?"))));
 
     if (fd >= 0) {
         (void) close(fd);
-        fileptr = fopen(config::files::save_game.c_str(), "wb");
     }
 
     DEBUG(logfile = fopen("IO_LOG", "a"))
     DEBUG(fprintf(logfile, "Saving data to %s\n", config::files::save_game))
 
-    if (fileptr != nullptr) {
-        xor_byte = 0;
-        wrByte(CURRENT_VERSION_MAJOR);
-        xor_byte = 0;
-        wrByte(CURRENT_VERSION_MINOR);
-        xor_byte = 0;
-        wrByte(CURRENT_VERSION_PATCH);
-        xor_byte = 0;
-
-        auto char_tmp = (uint8_t)(randomNumber(256) - 1);
-        wrByte(char_tmp);
-        // Note that xor_byte is now equal to char_tmp
-
-        ok = svWrite();
+    if (can_write) {
+        ok = saveToBuffer((uint8_t)(randomNumber(256) - 1));
 
         DEBUG(fclose(logfile))
 
-        if (fclose(fileptr) == EOF) {
-            ok = false;
-        }
+        ok = journalOutcome(ok && (headless || writeSaveFile(filename, save_buffer)));
+        save_buffer = std::vector<uint8_t>();
     }
 
     if (!ok) {
-        if (fd >= 0) {
-            (void) unlink(filename.c_str());
+        if (created) {
+            (void) saveFileRemove(filename);
         }
 
         std::string output;
-        if (fd >= 0) {
+        if (can_write) {
             output = "Error writing to file '" + filename + "'";
         } else {
             output = "Can't create new file '" + filename + "'";
@@ -454,15 +649,86 @@ static bool saveChar(const std::string &filename) {
     }
 
     game.character_saved = true;
+    simulationTimerStop();
     dg.game_turn = -1;
 
     return true;
 }
 
+static void autosaveWrite(const std::string filename, std::vector<uint8_t> buffer, std::atomic<bool> &finished, bool &ok) {
+    ok = writeSaveFile(filename, buffer);
+    finished = true;
+}
+
+// Saves the game without ending it, every so often and on each new level.
+// An autosave never overwrites a save file the game wasn't loaded from.
+// A headless game goes through the same steps, only without writing it.
+void autosaveGame() {
+    if (!config::options::autosave || !game.character_generated || game.character_is_dead || game.character_saved) {
+        return;
+    }
+
+    // Don't hold up play for the last autosave, try again next time
+    if (!journalOutcome(autosave_finished)) {
+        return;
+    }
+
+    if (!journalOutcome(autosaveWait())) {
+        printMessage("Autosave failed.");
+    }
+
+    const std::string &filename = config::files::save_game;
+
+    if (from_save_file == 0 && saveFileExists(filename)) {
+        return;
+    }
+
+    bool headless = terminalIsHeadless();
+
+    // Save with the speed fixed, as saveChar() does, but put it back after
+    int16_t heaviness = py.pack.heaviness;
+    uint32_t status = py.flags.status;
+    playerChangeSpeed(-heaviness);
+    py.pack.heaviness = 0;
+
+    // The xor seed doesn't come from the game's random numbers, so autosaves don't change the game
+    bool ok = journalOutcome(headless || saveToBuffer((uint8_t) dg.game_turn));
+
+    playerChangeSpeed(heaviness);
+    py.pack.heaviness = heaviness;
+    py.flags.status = status;
+
+    if (!ok) {
+        save_buffer = std::vector<uint8_t>();
+        printMessage("Autosave failed.");
+        return;
+    }
+
+    from_save_file = 1;
+
+    if (headless) {
+        return;
+    }
+
+    autosave_finished = false;
+    autosave_writer = std::thread(autosaveWrite, filename, std::move(save_buffer), std::ref(autosave_finished), std::ref(autosave_ok));
+    save_buffer = std::vector<uint8_t>();
+}
+
+// Waits for the autosave being written, if any, and tells whether the last one worked
+bool autosaveWait() {
+    if (autosave_writer.joinable()) {
+        autosave_writer.join();
+    }
+
+    bool ok = autosave_ok;
+    autosave_ok = true;
+
+    return ok;
+}
+
 // Certain checks are omitted for the wizard. -CJS-
 bool loadGame(bool &generate) {
-    Tile_t *tile = nullptr;
-    int c;
     uint32_t time_saved = 0;
     uint8_t version_maj = 0;
     uint8_t version_min = 0;
@@ -471,6 +737,7 @@ bool loadGame(bool &generate) {
     generate = true;
     int fd = -1;
     int total_count = 0;
+    std::vector<uint8_t> save_data;
 
     // Not required for Mac, because the file name is obtained through a dialog.
     // There is no way for a nonexistent file to be specified. -BS-
@@ -499,9 +766,9 @@ bool loadGame(bool &generate) {
 
         (void) close(fd);
         fd = -1; // Make sure it isn't closed again
-        fileptr = fopen(config::files::save_game.c_str(), "rb");
 
-        if (fileptr == nullptr) {
+        if (!readSaveFile(config::files::save_game, save_data)) {
+            putStringClearToEOL("The save file is unreadable or damaged.", Coord_t{2, 0});
             goto error;
         }
 
@@ -559,6 +826,8 @@ bool loadGame(bool &generate) {
         config::options::run_ignore_doors = (l & 0x100) != 0;
         config::options::error_beep_sound = (l & 0x200) != 0;
         config::options::display_counts = (l & 0x400) != 0;
+        config::options::autosave = (l & 0x800) == 0;
+        config::options::batch_messages = (l & 0x1000) != 0;
 
         // Don't allow resurrection of game.total_winner characters.  It causes
         // problems because the character level is out of the allowed range.
@@ -682,11 +951,22 @@ bool loadGame(bool &generate) {
             rdBytes(objects_identified, OBJECT_IDENT_SIZE);
             game.magic_seed = rdLong();
             game.town_seed = rdLong();
-            last_message_id = rdShort();
+
+            // The messages come in a ring, newest at the given index.
+            auto last_message_id = (int) rdShort();
+            vtype_t messages[MESSAGE_HISTORY_SIZE];
             for (auto &message : messages) {
                 rdString(message);
             }
 
+            messageLogClear();
+            for (int i = 1; i <= MESSAGE_HISTORY_SIZE; i++) {
+                char *message = messages[(last_message_id + i) % MESSAGE_HISTORY_SIZE];
+                if (message[0] != '\0') {
+                    messageLogAdd(message);
+                }
+            }
+
             uint16_t panic_save_short;
             uint16_t total_winner_short;
             panic_save_short = rdShort();
@@ -719,8 +999,7 @@ bool loadGame(bool &generate) {
             py.misc.date_of_birth = rdLong();
         }
 
-        c = getc(fileptr);
-        if (c == EOF || ((l & 0x80000000L) != 0)) {
+        if (load_position >= load_size || ((l & 0x80000000L) != 0)) {
             if ((l & 0x80000000L) == 0) {
                 if (!game.to_be_wizard || dg.game_turn < 0) {
                     goto error;
@@ -756,10 +1035,6 @@ bool loadGame(bool &generate) {
             putQIO();
             goto closefiles;
         }
-        if (ungetc(c, fileptr) == EOF) {
-            goto error;
-        }
-
         putStringClearToEOL("Restoring Character...", Coord_t{0, 0});
         putQIO();
 
@@ -782,11 +1057,11 @@ bool loadGame(bool &generate) {
         while (char_tmp != 0xFF) {
             ychar = char_tmp;
             xchar = rdByte();
-            char_tmp = rdByte();
-            if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT) {
+            uint16_t creature_id = load_format >= 2 ? rdShort() : rdByte();
+            if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT || creature_id >= MON_TOTAL_ALLOCATIONS) {
                 goto error;
             }
-            dg.floor[ychar][xchar].creature_id = char_tmp;
+            dg.floor[ychar][xchar].creature_id = creature_id;
             char_tmp = rdByte();
         }
 
@@ -799,26 +1074,25 @@ bool loadGame(bool &generate) {
             if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT) {
                 goto error;
             }
-            dg.floor[ychar][xchar].treasure_id = char_tmp;
+            treasurePutOnTile(Coord_t{ychar, xchar}, char_tmp);
             char_tmp = rdByte();
         }
 
         // read in the rest of the cave info
-        tile = &dg.floor[0][0];
         total_count = 0;
         while (total_count != MAX_HEIGHT * MAX_WIDTH) {
             count = rdByte();
             char_tmp = rdByte();
-            for (int i = count; i > 0; i--) {
-                if (tile >= &dg.floor[MAX_HEIGHT][0]) {
-                    goto error;
-                }
-                tile->feature_id = (uint8_t)(char_tmp & 0xF);
-                tile->perma_lit_room = (bool) ((char_tmp >> 4) & 0x1);
-                tile->field_mark = (bool) ((char_tmp >> 5) & 0x1);
-                tile->permanent_light = (bool) ((char_tmp >> 6) & 0x1);
-                tile->temporary_light = (bool) ((char_tmp >> 7) & 0x1);
-                tile++;
+            if (total_count + count > MAX_HEIGHT * MAX_WIDTH) {
+                goto error;
+            }
+            for (int i = total_count; i < total_count + count; i++) {
+                Tile_t tile = dg.floor[i / MAX_WIDTH][i % MAX_WIDTH];
+                tile.feature_id = (uint8_t)(char_tmp & 0xF);
+                tile.perma_lit_room = (bool) ((char_tmp >> 4) & 0x1);
+                tile.field_mark = (bool) ((char_tmp >> 5) & 0x1);
+                tile.permanent_light = (bool) ((char_tmp >> 6) & 0x1);
+                tile.temporary_light = (bool) ((char_tmp >> 7) & 0x1);
             }
             total_count += count;
         }
@@ -830,17 +1104,30 @@ bool loadGame(bool &generate) {
         for (int i = config::treasure::MIN_TREASURE_LIST_ID; i < game.treasure.current_id; i++) {
             rdItem(game.treasure.list[i]);
         }
+        monsterSlotsClear();
         next_free_monster_id = rdShort();
         if (next_free_monster_id > MON_TOTAL_ALLOCATIONS) {
             goto error;
         }
-        for (int i = config::monsters::MON_MIN_INDEX_ID; i < next_free_monster_id; i++) {
-            rdMonster(monsters[i]);
+        for (int i = config::monsters::MON_MIN_INDEX_ID, end = next_free_monster_id; i < end; i++) {
+            if (load_format < 2 || !rdBool()) {
+                rdMonster(monsters[i]);
+            } else if (i == end - 1) {
+                // Free slots at the top are never saved, the list would come out shorter
+                goto error;
+            } else {
+                monsterSlotFree(i);
+            }
         }
+        monsterIndexRebuild();
+        monsterScheduleClear();
+        losCacheInvalidate();
+        floorGlyphsForgetAll();
 
         generate = false; // We have restored a cave - no need to generate.
 
-        if (ferror(fileptr) != 0) {
+        // Reading past the end of the data means it was cut short
+        if (load_position > load_size) {
             goto error;
         }
 
@@ -859,11 +1146,8 @@ bool loadGame(bool &generate) {
 
         DEBUG(fclose(logfile));
 
-        if (fileptr != nullptr) {
-            if (fclose(fileptr) < 0) {
-                ok = false;
-            }
-        }
+        load_data = nullptr;
+
         if (fd >= 0) {
             (void) close(fd);
         }
@@ -942,31 +1226,31 @@ static void wrBool(bool value) {
 
 static void wrByte(uint8_t value) {
     xor_byte ^= value;
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, "BYTE:  %02X = %d\n", (int) xor_byte, (int) value))
 }
 
 static void wrShort(uint16_t value) {
     xor_byte ^= (value & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, "SHORT: %02X", (int) xor_byte))
     xor_byte ^= ((value >> 8) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, " %02X = %d\n", (int) xor_byte, (int) value))
 }
 
 static void wrLong(uint32_t value) {
     xor_byte ^= (value & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, "LONG:  %02X", (int) xor_byte))
     xor_byte ^= ((value >> 8) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, " %02X", (int) xor_byte))
     xor_byte ^= ((value >> 16) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, " %02X", (int) xor_byte))
     xor_byte ^= ((value >> 24) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, " %02X = %ld\n", (int) xor_byte, (int32_t) value))
 }
 
@@ -977,7 +1261,7 @@ static void wrBytes(uint8_t *value, int count) {
     ptr = value;
     for (int i = 0; i < count; i++) {
         xor_byte ^= *ptr++;
-        (void) putc((int) xor_byte, fileptr);
+        putByte(xor_byte);
         DEBUG(fprintf(logfile, "  %02X = %d", (int) xor_byte, (int) (ptr[-1])))
     }
     DEBUG(fprintf(logfile, "\n"))
@@ -988,11 +1272,11 @@ static void wrString(char *str) {
     DEBUG(fprintf(logfile, "STRING:"))
     while (*str != '\0') {
         xor_byte ^= *str++;
-        (void) putc((int) xor_byte, fileptr);
+        putByte(xor_byte);
         DEBUG(fprintf(logfile, " %02X", (int) xor_byte))
     }
     xor_byte ^= *str;
-    (void) putc((int) xor_byte, fileptr);
+    putByte(xor_byte);
     DEBUG(fprintf(logfile, " %02X = \"%s\"\n", (int) xor_byte, s))
 }
 
@@ -1003,10 +1287,10 @@ static void wrShorts(uint16_t *value, int count) {
 
     for (int i = 0; i < count; i++) {
         xor_byte ^= (*sptr & 0xFF);
-        (void) putc((int) xor_byte, fileptr);
+        putByte(xor_byte);
         DEBUG(fprintf(logfile, "  %02X", (int) xor_byte))
         xor_byte ^= ((*sptr++ >> 8) & 0xFF);
-        (void) putc((int) xor_byte, fileptr);
+        putByte(xor_byte);
         DEBUG(fprintf(logfile, " %02X = %d", (int) xor_byte, (int) sptr[-1]))
     }
     DEBUG(fprintf(logfile, "\n"))
@@ -1049,9 +1333,26 @@ static void wrMonster(Monster_t const &monster) {
     wrByte(monster.confused_amount);
 }
 
-// get_byte reads a single byte from a file, without any xor_byte encryption
+// putByte writes a single byte to the save buffer or file, without any xor_byte encryption
+static void putByte(uint8_t value) {
+    if (save_buffered) {
+        save_buffer.push_back(value);
+    } else {
+        (void) putc((int) value, fileptr);
+    }
+}
+
+// getByte reads a single byte from the loaded save data or file, without any xor_byte encryption
 static uint8_t getByte() {
-    return (uint8_t)(getc(fileptr) & 0xFF);
+    if (load_data == nullptr) {
+        return (uint8_t)(getc(fileptr) & 0xFF);
+    }
+
+    // Past the end reads as EOF did; load_position still counts on, to tell.
+    if (load_position++ >= load_size) {
+        return 0xFF;
+    }
+    return load_data[load_position - 1];
 }
 
 static bool rdBool() {
@@ -1172,6 +1473,9 @@ static void rdMonster(Monster_t &monster) {
     monster.lit = rdBool();
     monster.stunned_amount = rdByte();
     monster.confused_amount = rdByte();
+
+    // Not saved, the moves a far off monster saved up are lost
+    monster.far_off_moves = 0;
 }
 
 // functions called from death.c to implement the score file
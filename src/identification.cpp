@@ -11,10 +11,17 @@
 
 #include "headers.h"
 
-char magic_item_titles[MAX_TITLES][10];
+thread_local char magic_item_titles[MAX_TITLES][10];
+
+thread_local const char *colors[MAX_COLORS];
+thread_local const char *mushrooms[MAX_MUSHROOMS];
+thread_local const char *woods[MAX_WOODS];
+thread_local const char *metals[MAX_METALS];
+thread_local const char *rocks[MAX_ROCKS];
+thread_local const char *amulets[MAX_AMULETS];
 
 // Identified objects flags
-uint8_t objects_identified[OBJECT_IDENT_SIZE];
+thread_local uint8_t objects_identified[OBJECT_IDENT_SIZE];
 
 static const char *objectDescription(char command) {
     // every printing ASCII character is listed here, in the
@@ -235,6 +242,14 @@ void magicInitializeItemNames() {
 
     seedSet(game.magic_seed);
 
+    // Every game starts from the same order, not from the last game's shuffle
+    (void) memcpy(colors, color_names, sizeof colors);
+    (void) memcpy(mushrooms, mushroom_names, sizeof mushrooms);
+    (void) memcpy(woods, wood_names, sizeof woods);
+    (void) memcpy(metals, metal_names, sizeof metals);
+    (void) memcpy(rocks, rock_names, sizeof rocks);
+    (void) memcpy(amulets, amulet_names, sizeof amulets);
+
     // The first 3 entries for colors are fixed, (slime & apple juice, water)
     for (int i = 3; i < MAX_COLORS; i++) {
         id = randomNumber(MAX_COLORS - 3) + 2;
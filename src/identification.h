@@ -78,16 +78,24 @@ constexpr uint8_t MAX_AMULETS = 11;    // Used with amulets
 constexpr uint8_t MAX_TITLES = 45;     // Used with scrolls
 constexpr uint8_t MAX_SYLLABLES = 153; // Used with scrolls
 
-extern uint8_t objects_identified[OBJECT_IDENT_SIZE];
+extern thread_local uint8_t objects_identified[OBJECT_IDENT_SIZE];
 extern const char *special_item_names[SpecialNameIds::SN_ARRAY_SIZE];
 
 // Following are arrays for descriptive pieces
-extern const char *colors[MAX_COLORS];
-extern const char *mushrooms[MAX_MUSHROOMS];
-extern const char *woods[MAX_WOODS];
-extern const char *metals[MAX_METALS];
-extern const char *rocks[MAX_ROCKS];
-extern const char *amulets[MAX_AMULETS];
+extern const char *const color_names[MAX_COLORS];
+extern const char *const mushroom_names[MAX_MUSHROOMS];
+extern const char *const wood_names[MAX_WOODS];
+extern const char *const metal_names[MAX_METALS];
+extern const char *const rock_names[MAX_ROCKS];
+extern const char *const amulet_names[MAX_AMULETS];
+
+// This game's shuffle of them, see magicInitializeItemNames()
+extern thread_local const char *colors[MAX_COLORS];
+extern thread_local const char *mushrooms[MAX_MUSHROOMS];
+extern thread_local const char *woods[MAX_WOODS];
+extern thread_local const char *metals[MAX_METALS];
+extern thread_local const char *rocks[MAX_ROCKS];
+extern thread_local const char *amulets[MAX_AMULETS];
 extern const char *syllables[MAX_SYLLABLES];
 
 void identifyGameObject();
@@ -12,6 +12,8 @@
 #include "version.h"
 
 static bool parseGameSeed(const char *argv, uint32_t &seed);
+static bool copyFile(const std::string &from, const std::string &to);
+static void printSimulationReport();
 
 static const char *usage_instructions = R"(
 Usage:
@@ -23,6 +25,13 @@ Options:
     -n           Force start of new game
     -d           Display high scores and exit
     -s NUMBER    Game Seed, as a decimal number (max: 2147483647)
+    -f NUMBER    Screen updates a second while running, resting or repeating
+                 a command, 0 to only show where they stop (default: 30)
+    -k FILE      Run headless (no screen output), reading the keys from FILE
+    -j FILE      Record a journal of the game's seed and keys in FILE
+    -r FILE      Replay the journal FILE headless, as fast as it goes. A game
+                 that was loaded starts from the copy of its save file that
+                 was made next to the journal, as FILE.sav
 
     -v           Print version info and exit
     -h           Display this message
@@ -32,6 +41,10 @@ Options:
 int main(int argc, char *argv[]) {
     uint32_t seed = 0;
     bool new_game = false;
+    bool show_scores = false;
+    const char *key_script = nullptr;
+    const char *journal = nullptr;
+    const char *replay = nullptr;
 
     // call this routine to grab a file pointer to the high score file
     // and prepare things to relinquish setuid privileges
@@ -45,23 +58,17 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    if (!terminalInitialize()) {
-        return 1;
-    }
-
     // check for user interface option
     for (--argc, ++argv; argc > 0 && argv[0][0] == '-'; --argc, ++argv) {
         switch (argv[0][1]) {
             case 'v':
-                terminalRestore();
                 printf("%d.%d.%d\n", CURRENT_VERSION_MAJOR, CURRENT_VERSION_MINOR, CURRENT_VERSION_PATCH);
                 return 0;
             case 'n':
                 new_game = true;
                 break;
             case 'd':
-                showScoresScreen();
-                exitProgram();
+                show_scores = true;
                 break;
             case 's':
                 // No NUMBER provided?
@@ -74,18 +81,62 @@ int main(int argc, char *argv[]) {
                 ++argv;
 
                 if (!parseGameSeed(argv[0], seed)) {
-                    terminalRestore();
                     printf("Game seed must be a decimal number between 1 and 2147483647\n");
                     return -1;
                 }
 
+                break;
+            case 'f': {
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                --argc;
+                ++argv;
+
+                int frame_rate;
+                if (!stringToNumber(argv[0], frame_rate) || frame_rate < 0 || frame_rate > UINT8_MAX) {
+                    printf("Frame rate must be a decimal number between 0 and %d\n", UINT8_MAX);
+                    return -1;
+                }
+                config::options::run_frame_rate = (uint8_t) frame_rate;
+
+                break;
+            }
+            case 'k':
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                --argc;
+                ++argv;
+
+                key_script = argv[0];
+                break;
+            case 'j':
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                --argc;
+                ++argv;
+
+                journal = argv[0];
+                break;
+            case 'r':
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                --argc;
+                ++argv;
+
+                replay = argv[0];
                 break;
             case 'w':
                 game.to_be_wizard = true;
                 break;
             default:
-                terminalRestore();
-
                 printf("Robert A. Koeneke's classic dungeon crawler.\n");
                 printf("Umoria %d.%d.%d is released under a GPL v2 license.\n", CURRENT_VERSION_MAJOR, CURRENT_VERSION_MINOR, CURRENT_VERSION_PATCH);
                 printf("%s", usage_instructions);
@@ -99,11 +150,111 @@ int main(int argc, char *argv[]) {
         config::files::save_game = argv[0];
     }
 
-    startMoria(seed, new_game);
+    JournalStart_t start{seed, new_game, game.to_be_wizard};
+
+    if (replay != nullptr) {
+        if (!terminalInitializeReplay(replay, start)) {
+            std::cerr << "Can't replay journal '" << replay << "'\n";
+            return 1;
+        }
+        seed = start.seed;
+        new_game = start.new_game;
+        game.to_be_wizard = start.wizard;
+
+        // Without that copy the game was new after all, as it will be now
+        if (!new_game) {
+            config::files::save_game = std::string(replay) + ".sav";
+        }
+    } else if (key_script != nullptr) {
+        if (!terminalInitializeHeadless(key_script)) {
+            std::cerr << "Can't open key script '" << key_script << "'\n";
+            return 1;
+        }
+    } else if (!terminalInitialize()) {
+        return 1;
+    }
+
+    // The game can only be replayed with the seed it really got
+    if (journal != nullptr) {
+        if (start.seed == 0) {
+            start.seed = getCurrentUnixTime();
+            seed = start.seed;
+        }
+
+        if (!terminalRecordJournal(journal, start)) {
+            terminalRestore();
+            std::cerr << "Can't write journal '" << journal << "'\n";
+            return 1;
+        }
+
+        // The game saves over the file it was loaded from, so
+        // the replay needs a copy of it as it was at the start
+        std::string journal_save = std::string(journal) + ".sav";
+        (void) unlink(journal_save.c_str());
+
+        if (!new_game && access(config::files::save_game.c_str(), 0) == 0 && !copyFile(config::files::save_game, journal_save)) {
+            terminalRestore();
+            std::cerr << "Can't copy save file '" << config::files::save_game << "' to '" << journal_save << "'\n";
+            return 1;
+        }
+    }
+
+    // Only a headless game returns from exitProgram(), by throwing GameExit_t
+    try {
+        if (show_scores) {
+            showScoresScreen();
+            exitProgram();
+        }
+
+        startMoria(seed, new_game);
+    } catch (const GameExit_t &) {
+        printSimulationReport();
+    }
 
     return 0;
 }
 
+// Print the turns per second figure of a headless game
+static void printSimulationReport() {
+    int32_t turns = simulationTurns();
+    double seconds = simulationSeconds();
+
+    double turns_per_second = 0;
+    if (seconds > 0) {
+        turns_per_second = turns / seconds;
+    }
+
+    printf("%s: %d game turns in %.3f seconds (%.1f turns/second)\n", game.character_died_from, turns, seconds, turns_per_second);
+    printf("Compactions: %d objects, %d monsters\n", game.compactions.objects, game.compactions.monsters);
+}
+
+static bool copyFile(const std::string &from, const std::string &to) {
+    FILE *source = fopen(from.c_str(), "rb");
+    if (source == nullptr) {
+        return false;
+    }
+
+    FILE *target = fopen(to.c_str(), "wb");
+    if (target == nullptr) {
+        (void) fclose(source);
+        return false;
+    }
+
+    char buffer[4096];
+    size_t count;
+    bool ok = true;
+
+    while (ok && (count = fread(buffer, 1, sizeof(buffer), source)) > 0) {
+        ok = fwrite(buffer, 1, count, target) == count;
+    }
+
+    ok = ferror(source) == 0 && ok;
+    (void) fclose(source);
+    ok = fclose(target) == 0 && ok;
+
+    return ok;
+}
+
 static bool parseGameSeed(const char *argv, uint32_t &seed) {
     int value;
 
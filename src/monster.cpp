@@ -10,9 +10,11 @@
 
 #include "headers.h"
 
+#include <cmath>
+
 // A horrible hack, needed because compact_monster() is called from
 // deep within updateMonsters() via monsterPlaceNew() and monsterSummon()
-int hack_monptr = -1;
+thread_local int hack_monptr = -1;
 
 static bool executeAttackOnPlayer(uint8_t creature_level, int16_t &monster_hp, int monster_id, int attack_type, int damage, vtype_t death_description, bool noticed);
 
@@ -49,7 +51,7 @@ void monsterUpdateVisibility(int monster_id) {
         if (game.wizard_mode) {
             // Wizard sight.
             visible = true;
-        } else if (los(py.pos, monster.pos)) {
+        } else if (losFromPlayer(monster.pos)) {
             visible = monsterIsVisible(monster);
         }
     }
@@ -59,6 +61,7 @@ void monsterUpdateVisibility(int monster_id) {
         if (!monster.lit) {
             playerDisturb(1, 0);
             monster.lit = true;
+            floorGlyphForget(monster.pos);
             dungeonLiteSpot(Coord_t{monster.pos.y, monster.pos.x});
 
             // notify inventoryExecuteCommand()
@@ -67,6 +70,7 @@ void monsterUpdateVisibility(int monster_id) {
     } else if (monster.lit) {
         // Turn it off.
         monster.lit = false;
+        floorGlyphForget(monster.pos);
         dungeonLiteSpot(Coord_t{monster.pos.y, monster.pos.x});
 
         // notify inventoryExecuteCommand()
@@ -477,7 +481,7 @@ static void monsterAttackPlayer(int monster_id) {
     }
 }
 
-static void monsterOpenDoor(Tile_t &tile, int16_t monster_hp, uint32_t move_bits, bool &do_turn, bool &do_move, uint32_t &rcmove, Coord_t coord) {
+static void monsterOpenDoor(Tile_t tile, int16_t monster_hp, uint32_t move_bits, bool &do_turn, bool &do_move, uint32_t &rcmove, Coord_t coord) {
     Inventory_t &item = game.treasure.list[tile.treasure_id];
 
     // Creature can open doors.
@@ -520,6 +524,7 @@ static void monsterOpenDoor(Tile_t &tile, int16_t monster_hp, uint32_t move_bits
                 item.misc_use = (int16_t)(1 - randomNumber(2));
             }
             tile.feature_id = TILE_CORR_FLOOR;
+            losCacheInvalidate();
             dungeonLiteSpot(coord);
             rcmove |= config::monsters::move::CM_OPEN_DOOR;
             do_move = false;
@@ -535,6 +540,7 @@ static void monsterOpenDoor(Tile_t &tile, int16_t monster_hp, uint32_t move_bits
             // 50% chance of breaking door
             item.misc_use = (int16_t)(1 - randomNumber(2));
             tile.feature_id = TILE_CORR_FLOOR;
+            losCacheInvalidate();
             dungeonLiteSpot(coord);
             printMessage("You hear a door burst open!");
             playerDisturb(1, 0);
@@ -560,7 +566,7 @@ static void glyphOfWardingProtection(uint16_t creature_id, uint32_t move_bits, b
     }
 }
 
-static void monsterMovesOnPlayer(Monster_t const &monster, uint8_t creature_id, int monster_id, uint32_t move_bits, bool &do_move, bool &do_turn, uint32_t &rcmove, Coord_t coord) {
+static void monsterMovesOnPlayer(Monster_t const &monster, uint16_t creature_id, int monster_id, uint32_t move_bits, bool &do_move, bool &do_turn, uint32_t &rcmove, Coord_t coord) {
     if (creature_id == 1) {
         // if the monster is not lit, must call monsterUpdateVisibility, it
         // may be faster than character, and hence could have
@@ -581,15 +587,8 @@ static void monsterMovesOnPlayer(Monster_t const &monster, uint8_t creature_id,
                 rcmove |= config::monsters::move::CM_EATS_OTHER;
             }
 
-            // It ate an already processed monster. Handle normally.
-            if (monster_id < creature_id) {
-                dungeonDeleteMonster((int) creature_id);
-            } else {
-                // If it eats this monster, an already processed
-                // monster will take its place, causing all kinds
-                // of havoc. Delay the kill a bit.
-                dungeonDeleteMonsterFix1((int) creature_id);
-            }
+            // Only its slot is freed, so the rest of this pass goes on as it was
+            dungeonDeleteMonster((int) creature_id);
         } else {
             do_move = false;
         }
@@ -612,6 +611,7 @@ static void monsterAllowedToMove(Monster_t &monster, uint32_t move_bits, bool &d
 
     if (monster.lit) {
         monster.lit = false;
+        floorGlyphForget(monster.pos);
         dungeonLiteSpot(Coord_t{monster.pos.y, monster.pos.x});
     }
 
@@ -639,7 +639,7 @@ static void makeMove(int monster_id, int *directions, uint32_t &rcmove) {
 
         (void) playerMovePosition(directions[i], coord);
 
-        Tile_t &tile = dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
         if (tile.feature_id == TILE_BOUNDARY_WALL) {
             continue;
@@ -684,7 +684,7 @@ static bool monsterCanCastSpells(Monster_t const &monster, uint32_t spells) {
     bool within_range = monster.distance_from_player <= config::monsters::MON_MAX_SPELL_CAST_DISTANCE;
 
     // Must have unobstructed Line-Of-Sight
-    bool unobstructed = los(py.pos, monster.pos);
+    bool unobstructed = losFromPlayer(monster.pos);
 
     return within_range && unobstructed;
 }
@@ -941,15 +941,8 @@ bool monsterMultiply(Coord_t coord, int creature_id, int monster_id) {
                     bool experienced = creatures_list[creature_id].kill_exp_value >= creatures_list[monsters[tile.creature_id].creature_id].kill_exp_value;
 
                     if (cannibalistic && experienced) {
-                        // It ate an already processed monster. Handle * normally.
-                        if (monster_id < tile.creature_id) {
-                            dungeonDeleteMonster((int) tile.creature_id);
-                        } else {
-                            // If it eats this monster, an already processed
-                            // monster will take its place, causing all kinds
-                            // of havoc. Delay the kill a bit.
-                            dungeonDeleteMonsterFix1((int) tile.creature_id);
-                        }
+                        // Only its slot is freed, so the rest of this pass goes on as it was
+                        dungeonDeleteMonster((int) tile.creature_id);
 
                         // in case compact_monster() is called, it needs monster_id.
                         hack_monptr = monster_id;
@@ -988,11 +981,10 @@ bool monsterMultiply(Coord_t coord, int creature_id, int monster_id) {
 static void monsterMultiplyCritter(Monster_t const &monster, int monster_id, uint32_t &rcmove) {
     int counter = 0;
 
-    Coord_t coord = Coord_t{0, 0};
-
-    for (coord.y = monster.pos.y - 1; coord.y <= monster.pos.y + 1; coord.y++) {
-        for (coord.x = monster.pos.x - 1; coord.x <= monster.pos.x + 1; coord.x++) {
-            if (coordInBounds(coord) && (dg.floor[coord.y][coord.x].creature_id > 1)) {
+    // Monsters never stand in the outer wall, so the tiles round them are all on the map
+    for (int y = monster.pos.y - 1; y <= monster.pos.y + 1; y++) {
+        for (int x = monster.pos.x - 1; x <= monster.pos.x + 1; x++) {
+            if (dg.floor.creature_ids[y][x] > 1) {
                 counter++;
             }
         }
@@ -1135,6 +1127,82 @@ static void monsterMoveRandomly(int monster_id, uint32_t &rcmove, int randomness
     makeMove(monster_id, directions, rcmove);
 }
 
+// Puts the directions that take a monster nearer the player by the flow field
+// first, fewest steps first, then fills up with the directions it had already.
+// This takes monsters round walls, rather than into them. Monsters that walk
+// through walls, or are too far away for the flow field, keep their directions.
+static void monsterFollowFlow(int monster_id, int *directions) {
+    Monster_t const &monster = monsters[monster_id];
+
+    if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_PHASE) != 0u) {
+        return;
+    }
+
+    int steps_by_dir[10];
+    flowStepsAround(monster.pos, steps_by_dir);
+
+    int here = steps_by_dir[5];
+    if (here <= 0) {
+        return;
+    }
+
+    int nearer[8];
+    int nearer_steps[8];
+    int count = 0;
+
+    // Walked in the order the directions were given, so they break ties
+    int order[13];
+    for (int i = 0; i < 5; i++) {
+        order[i] = directions[i];
+    }
+    for (int i = 0, dir = 1; dir <= 9; dir++) {
+        if (dir != 5) {
+            order[5 + i++] = dir;
+        }
+    }
+
+    for (int dir : order) {
+        int steps = steps_by_dir[dir];
+        if (steps < 0 || steps >= here) {
+            continue;
+        }
+
+        // Each direction is only taken once
+        steps_by_dir[dir] = -1;
+
+        int i = count++;
+        for (; i > 0 && nearer_steps[i - 1] > steps; i--) {
+            nearer[i] = nearer[i - 1];
+            nearer_steps[i] = nearer_steps[i - 1];
+        }
+        nearer[i] = dir;
+        nearer_steps[i] = steps;
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    int given[5];
+    for (int i = 0; i < 5; i++) {
+        given[i] = directions[i];
+    }
+
+    int total = 0;
+    for (int i = 0; i < count && total < 5; i++) {
+        directions[total++] = nearer[i];
+    }
+    for (int i = 0; i < 5 && total < 5; i++) {
+        bool taken = false;
+        for (int j = 0; j < count; j++) {
+            taken |= nearer[j] == given[i];
+        }
+        if (!taken) {
+            directions[total++] = given[i];
+        }
+    }
+}
+
 static void monsterMoveNormally(int monster_id, uint32_t &rcmove) {
     int directions[9];
 
@@ -1146,6 +1214,7 @@ static void monsterMoveNormally(int monster_id, uint32_t &rcmove) {
         directions[4] = randomNumber(9);
     } else {
         monsterGetMoveDirection(monster_id, directions);
+        monsterFollowFlow(monster_id, directions);
     }
 
     rcmove |= config::monsters::move::CM_MOVE_NORMAL;
@@ -1255,33 +1324,87 @@ static void memoryUpdateRecall(Monster_t const &monster, bool wake, bool ignore,
     memory.movement |= rcmove;
 }
 
+// Noise is counted in units of 1/2^40 of the hazard, see monsterHearsPlayer(),
+// fine enough that even the faintest noise is within a millionth of its hazard
+constexpr double MON_NOISE_UNITS = (double) ((int64_t) 1 << 40);
+
+// The noise a sleeping monster hears each turn, when the player is up and
+// about, or else resting or paralysed. Every turn a monster notices the player
+// with the chance that (1..1024)^3 <= 2^(29 - stealth), only 1 in 50 of that
+// while the player is resting. A chance p is a hazard of -ln(1 - p).
+static int64_t monsterNoisePerTurn(bool player_resting) {
+    static thread_local int16_t stealth = INT16_MIN;
+    static thread_local int64_t noise[2];
+
+    if (stealth != py.misc.stealth_factor) {
+        stealth = py.misc.stealth_factor;
+
+        int64_t limit = (int64_t) 1 << (29 - stealth);
+        int64_t notices = 0;
+        while (notices < 1024 && (notices + 1) * (notices + 1) * (notices + 1) <= limit) {
+            notices++;
+        }
+
+        double chance = (double) notices / 1024;
+
+        noise[0] = chance >= 1 ? INT64_MAX : std::llround(-std::log1p(-chance) * MON_NOISE_UNITS);
+        noise[1] = std::llround(-std::log1p(-chance / 50) * MON_NOISE_UNITS);
+    }
+
+    return noise[player_resting ? 1 : 0];
+}
+
+// Does a sleeping monster notice the player this turn? Rather than rolling the dice
+// every turn, each monster draws how much noise it takes to disturb it, with the
+// exponential distribution, and counts it down by each turn's hazard. That gives
+// it the same chance of noticing the player on each turn as rolling would. When it
+// does, the player's distance tells how loud it was, in sleep the monster loses.
+static bool monsterHearsPlayer(Monster_t &monster, int &loudness) {
+    if (monster.noise_left <= 0) {
+        double uniform = (double) rnd() / INT32_MAX;
+        monster.noise_left = (int64_t) (-std::log(uniform) * MON_NOISE_UNITS) + 1;
+    }
+
+    int64_t noise = monsterNoisePerTurn(py.flags.rest != 0 || py.flags.paralysis > 0);
+
+    if (noise < monster.noise_left) {
+        monster.noise_left -= noise;
+        return false;
+    }
+
+    monster.noise_left = 0;
+    loudness = 100 / monster.distance_from_player;
+    return true;
+}
+
+// Does a monster get to do anything on its turn? Monsters trapped in rock
+// must be given a turn also, so that they will die/dig out immediately.
+static bool monsterInReach(Monster_t const &monster) {
+    return monster.lit || monster.distance_from_player <= creatures_list[monster.creature_id].area_affect_radius ||
+           (((creatures_list[monster.creature_id].movement & config::monsters::move::CM_PHASE) == 0u) && dg.floor[monster.pos.y][monster.pos.x].feature_id >= MIN_CAVE_WALL);
+}
+
 static void monsterAttackingUpdate(Monster_t &monster, int monster_id, int moves) {
     for (int i = moves; i > 0; i--) {
         bool wake = false;
         bool ignore = false;
+        int loudness = 0;
 
         uint32_t rcmove = 0;
 
-        // Monsters trapped in rock must be given a turn also,
-        // so that they will die/dig out immediately.
-        if (monster.lit || monster.distance_from_player <= creatures_list[monster.creature_id].area_affect_radius ||
-            (((creatures_list[monster.creature_id].movement & config::monsters::move::CM_PHASE) == 0u) && dg.floor[monster.pos.y][monster.pos.x].feature_id >= MIN_CAVE_WALL)) {
+        if (monsterInReach(monster)) {
             if (monster.sleep_count > 0) {
                 if (py.flags.aggravate) {
                     monster.sleep_count = 0;
-                } else if ((py.flags.rest == 0 && py.flags.paralysis < 1) || (randomNumber(50) == 1)) {
-                    int notice = randomNumber(1024);
-
-                    if (notice * notice * notice <= (1L << (29 - py.misc.stealth_factor))) {
-                        monster.sleep_count -= (100 / monster.distance_from_player);
-                        if (monster.sleep_count > 0) {
-                            ignore = true;
-                        } else {
-                            wake = true;
-
-                            // force it to be exactly zero
-                            monster.sleep_count = 0;
-                        }
+                } else if (monsterHearsPlayer(monster, loudness)) {
+                    monster.sleep_count -= loudness;
+                    if (monster.sleep_count > 0) {
+                        ignore = true;
+                    } else {
+                        wake = true;
+
+                        // force it to be exactly zero
+                        monster.sleep_count = 0;
                     }
                 }
             }
@@ -1312,10 +1435,100 @@ static void monsterAttackingUpdate(Monster_t &monster, int monster_id, int moves
     }
 }
 
+// Monsters far off the player move in less detail. An awake monster that walks
+// normally, more than MON_FAR_OFF_DISTANCE away, which the player can't see and
+// which has no line of sight to the player, can neither cast a spell at the player
+// nor reach them, so all it does is follow the flow field towards the player.
+static bool monsterIsFarOff(Monster_t const &monster) {
+    if (monster.lit || monster.sleep_count != 0 || monster.stunned_amount != 0 || monster.confused_amount != 0 ||
+        monster.distance_from_player <= config::monsters::MON_FAR_OFF_DISTANCE) {
+        return false;
+    }
+
+    Creature_t const &creature = creatures_list[monster.creature_id];
+
+    // Out of its reach it does nothing at all, see monsterAttackingUpdate()
+    if (monster.distance_from_player > creature.area_affect_radius || dg.floor.feature_ids[monster.pos.y][monster.pos.x] > MAX_OPEN_SPACE) {
+        return false;
+    }
+
+    uint32_t other_moves = config::monsters::move::CM_MULTIPLY | config::monsters::move::CM_PHASE | config::monsters::move::CM_ATTACK_ONLY |
+                           config::monsters::move::CM_20_RANDOM | config::monsters::move::CM_40_RANDOM | config::monsters::move::CM_75_RANDOM;
+
+    if ((creature.movement & config::monsters::move::CM_MOVE_NORMAL) == 0u || (creature.movement & other_moves) != 0u) {
+        return false;
+    }
+
+    return flowStepsToPlayer(monster.pos) > 0 && !losFromPlayer(monster.pos);
+}
+
+// Steps a far off monster onto the empty floor around it that is fewest steps
+// from the player. Returns false when no such tile is nearer the player.
+static bool monsterFarOffStep(Monster_t &monster) {
+    int steps_by_dir[10];
+    flowStepsAround(monster.pos, steps_by_dir);
+
+    int best_steps = steps_by_dir[5];
+    Coord_t best = monster.pos;
+
+    for (int dir = 1; dir <= 9; dir++) {
+        Coord_t coord = monster.pos;
+
+        if (dir == 5 || steps_by_dir[dir] < 0 || steps_by_dir[dir] >= best_steps || !playerMovePosition(dir, coord)) {
+            continue;
+        }
+
+        // Doors, objects and other creatures need the full rules
+        if (dg.floor.feature_ids[coord.y][coord.x] > MAX_OPEN_SPACE || dg.floor.creature_ids[coord.y][coord.x] != 0 || dg.floor.treasure_ids[coord.y][coord.x] != 0) {
+            continue;
+        }
+
+        best_steps = steps_by_dir[dir];
+        best = coord;
+    }
+
+    if (best_steps == steps_by_dir[5]) {
+        return false;
+    }
+
+    dungeonMoveCreatureRecord(monster.pos, best);
+    monster.pos = best;
+    monster.distance_from_player = (uint8_t) coordDistanceBetween(py.pos, best);
+
+    return true;
+}
+
+// A far off monster saves up its moves, and takes them all every MON_FAR_OFF_TURNS
+// game turns. The moves left once it can't take such a step, or is no longer far
+// off, are taken under the full rules.
+static void monsterFarOffUpdate(Monster_t &monster, int monster_id, int moves) {
+    monster.far_off_moves = (uint8_t) std::min(monster.far_off_moves + moves, (int) UINT8_MAX);
+
+    if ((dg.game_turn + monster_id) % config::monsters::MON_FAR_OFF_TURNS != 0) {
+        monsterUpdateVisibility(monster_id);
+        return;
+    }
+
+    moves = monster.far_off_moves;
+    monster.far_off_moves = 0;
+
+    while (moves > 0 && monsterIsFarOff(monster) && monsterFarOffStep(monster)) {
+        moves--;
+    }
+
+    if (moves > 0) {
+        monsterAttackingUpdate(monster, monster_id, moves);
+    } else {
+        monsterUpdateVisibility(monster_id);
+    }
+}
+
 // Creatures movement and attacking are done from here -RAK-
 void updateMonsters(bool attack) {
-    // Process the monsters
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID && !game.character_is_dead; id--) {
+    monsterScheduleStartPass();
+
+    // Process the monsters, leaving out the parked ones
+    for (int id = monsterScheduleNext(next_free_monster_id); id >= config::monsters::MON_MIN_INDEX_ID && !game.character_is_dead; id = monsterScheduleNext(id)) {
         Monster_t &monster = monsters[id];
 
         // Get rid of an eaten/breathed on monster.  Note: Be sure not to
@@ -1334,7 +1547,12 @@ void updateMonsters(bool attack) {
 
             if (moves <= 0) {
                 monsterUpdateVisibility(id);
+            } else if (monsterIsFarOff(monster)) {
+                monsterFarOffUpdate(monster, id, moves);
             } else {
+                // Moves saved up while far off are taken now
+                moves += monster.far_off_moves;
+                monster.far_off_moves = 0;
                 monsterAttackingUpdate(monster, id, moves);
             }
         } else {
@@ -1348,6 +1566,84 @@ void updateMonsters(bool attack) {
             dungeonDeleteMonsterFix2(id);
             continue;
         }
+
+        // Only once a turn, between the player's moves
+        if (attack) {
+            monsterSchedulePark(id);
+        }
+    }
+}
+
+// The moves a monster gets over the next `turns` turns of a rest, see monsterMovementRate()
+static int64_t monsterRestMoves(Monster_t const &monster, int turns) {
+    if (monster.speed > 0) {
+        return turns;
+    }
+
+    int64_t period = 2 - monster.speed;
+
+    return (dg.game_turn + turns) / period - dg.game_turn / period;
+}
+
+// How many of the next `turns` turns of a rest the monsters would play out with no
+// more than sleeping monsters listening for the player, see playerRestFastForward().
+// None of them would notice the player, or draw a random number, up to the turn
+// after those. 0 when a monster in reach is awake, stunned or yet to draw the noise
+// that disturbs it.
+int monstersRestTurns(int turns) {
+    int64_t noise = monsterNoisePerTurn(true);
+
+    monsterScheduleStartPass();
+
+    for (int id = monsterScheduleNext(next_free_monster_id); id >= config::monsters::MON_MIN_INDEX_ID && turns > 0; id = monsterScheduleNext(id)) {
+        Monster_t &monster = monsters[id];
+
+        if (monster.hp < 0 || monster.far_off_moves != 0) {
+            return 0;
+        }
+
+        // As the turns themselves would, while the player stays put
+        monster.distance_from_player = (uint8_t) coordDistanceBetween(py.pos, monster.pos);
+
+        if (!monsterInReach(monster)) {
+            continue;
+        }
+
+        if (monster.sleep_count <= 0 || monster.stunned_amount != 0 || py.flags.aggravate || monster.noise_left <= 0) {
+            return 0;
+        }
+
+        // It notices the player on the move that takes the noise left down to 0
+        int64_t quiet_moves = noise == 0 ? INT64_MAX : (monster.noise_left - 1) / noise;
+
+        if (quiet_moves >= monsterRestMoves(monster, turns)) {
+            continue;
+        }
+
+        if (monster.speed > 0) {
+            turns = (int) quiet_moves;
+        } else {
+            int64_t period = 2 - monster.speed;
+            turns = (int) ((dg.game_turn / period + quiet_moves + 1) * period - dg.game_turn - 1);
+        }
+    }
+
+    return turns;
+}
+
+// Plays `turns` turns of a rest for the monsters, all of which
+// monstersRestTurns() found could be played in one go.
+void monstersRest(int turns) {
+    int64_t noise = monsterNoisePerTurn(true);
+
+    monsterScheduleStartPass();
+
+    for (int id = monsterScheduleNext(next_free_monster_id); id >= config::monsters::MON_MIN_INDEX_ID; id = monsterScheduleNext(id)) {
+        Monster_t &monster = monsters[id];
+
+        if (monsterInReach(monster)) {
+            monster.noise_left -= noise * monsterRestMoves(monster, turns);
+        }
     }
 }
 
@@ -1359,6 +1655,7 @@ int monsterTakeHit(int monster_id, int damage) {
 
     monster.sleep_count = 0;
     monster.hp -= damage;
+    monsterScheduleWake(monster_id);
 
     if (monster.hp >= 0) {
         return -1;
@@ -1388,9 +1685,9 @@ int monsterTakeHit(int monster_id, int damage) {
     // message appearing before "monster dies" message.
     int m_take_hit = monster.creature_id;
 
-    // in case this is called from within updateMonsters(), this is a horrible
-    // hack, the monsters/updateMonsters() code needs to be rewritten.
-    if (hack_monptr < monster_id) {
+    // in case this is called from within updateMonsters(), the monster whose
+    // turn it is keeps its record until the turn is over.
+    if (hack_monptr != monster_id) {
         dungeonDeleteMonster(monster_id);
     } else {
         dungeonDeleteMonsterFix1(monster_id);
@@ -1512,7 +1809,7 @@ bool monsterSleep(Coord_t coord) {
 
     for (int y = coord.y - 1; y <= coord.y + 1 && y < MAX_HEIGHT; y++) {
         for (int x = coord.x - 1; x <= coord.x + 1 && x < MAX_WIDTH; x++) {
-            uint8_t monster_id = dg.floor[y][x].creature_id;
+            int monster_id = dg.floor[y][x].creature_id;
 
             if (monster_id <= 1) {
                 continue;
@@ -22,6 +22,9 @@ typedef struct {
     bool lit;
     uint8_t stunned_amount;
     uint8_t confused_amount;
+    uint8_t far_off_moves; // Moves saved up while far off the player
+
+    int64_t noise_left; // Noise still needed to disturb its sleep, 0 when not drawn yet
 } Monster_t;
 
 // Creature_t is a base data object.
@@ -55,24 +58,28 @@ typedef struct {
 constexpr uint16_t MON_MAX_CREATURES = 279; // Number of creatures defined for univ
 constexpr uint8_t MON_ATTACK_TYPES = 215;   // Number of monster attack types.
 
-// With MON_TOTAL_ALLOCATIONS set to 101, it is possible to get compacting
-// monsters messages while breeding/cloning monsters.
-constexpr uint8_t MON_TOTAL_ALLOCATIONS = 125; // Max that can be allocated
+// The size of the monster list. It was 125 when monster ids were bytes, and
+// levels full of breeders kept having to compact it, killing off far away
+// monsters at random. Tiles hold 16-bit monster ids now, so it can be set as
+// high as INT16_MAX, which is what the monster index and schedule can hold.
+constexpr uint16_t MON_TOTAL_ALLOCATIONS = 4096; // Max that can be allocated
 constexpr uint8_t MON_MAX_LEVELS = 40;         // Maximum level of creatures
 constexpr uint8_t MON_MAX_ATTACKS = 4;         // Max num attacks (used in mons memory) -CJS-
 
-extern int hack_monptr;
+extern thread_local int hack_monptr;
 extern Creature_t creatures_list[MON_MAX_CREATURES];
-extern Monster_t monsters[MON_TOTAL_ALLOCATIONS];
-extern int16_t monster_levels[MON_MAX_LEVELS + 1];
+extern thread_local Monster_t monsters[MON_TOTAL_ALLOCATIONS];
+extern thread_local int16_t monster_levels[MON_MAX_LEVELS + 1];
 extern MonsterAttack_t monster_attacks[MON_ATTACK_TYPES];
 extern Monster_t blank_monster;
-extern int16_t next_free_monster_id;
-extern int16_t monster_multiply_total;
+extern thread_local int16_t next_free_monster_id;
+extern thread_local int16_t monster_multiply_total;
 
 void monsterUpdateVisibility(int monster_id);
 bool monsterMultiply(Coord_t coord, int creature_id, int monster_id);
 void updateMonsters(bool attack);
+int monstersRestTurns(int turns);
+void monstersRest(int turns);
 uint32_t monsterDeath(Coord_t coord, uint32_t flags);
 int monsterTakeHit(int monster_id, int damage);
 void printMonsterActionText(const std::string &name, const std::string &action);
@@ -86,3 +93,27 @@ void monsterPlaceWinning();
 void monsterPlaceNewWithinDistance(int number, int distance_from_source, bool sleeping);
 bool monsterSummon(Coord_t &coord, bool sleeping);
 bool monsterSummonUndead(Coord_t &coord);
+
+// monster list slots
+void monsterSlotsClear();
+void monsterSlotFree(int monster_id);
+bool monsterSlotIsFree(int monster_id);
+int monsterSlotsLeft();
+
+// monster spatial index
+void monsterIndexClear();
+void monsterIndexRebuild();
+void monsterIndexAdd(int monster_id);
+void monsterIndexRemove(int monster_id);
+void monsterIndexMove(int monster_id, Coord_t const &to);
+int monstersInArea(Coord_t const &top_left, Coord_t const &bottom_right, int16_t *ids);
+int monstersWithinDistance(Coord_t const &coord, int distance, int16_t *ids);
+
+// monster turn schedule
+void monsterScheduleClear();
+void monsterScheduleWake(int monster_id);
+void monsterScheduleWakeAll();
+void monsterSchedulePlayerStep();
+void monsterScheduleStartPass();
+int monsterScheduleNext(int monster_id);
+void monsterSchedulePark(int monster_id);
@@ -10,24 +10,401 @@
 
 #include "headers.h"
 
-Monster_t monsters[MON_TOTAL_ALLOCATIONS];
-int16_t monster_levels[MON_MAX_LEVELS + 1];
+#include <algorithm>
+
+thread_local Monster_t monsters[MON_TOTAL_ALLOCATIONS];
+thread_local int16_t monster_levels[MON_MAX_LEVELS + 1];
 
 // Values for a blank monster
-Monster_t blank_monster = {0, 0, 0, 0, Coord_t{0, 0}, 0, false, 0, 0};
+Monster_t blank_monster = {0, 0, 0, 0, Coord_t{0, 0}, 0, false, 0, 0, 0, 0};
+
+thread_local int16_t next_free_monster_id;   // One past the highest monster slot in use
+thread_local int16_t monster_multiply_total; // Total number of reproduction's of creatures
+
+// The slots of the monster list. A deleted monster's slot is left free, rather
+// than having the last monster moved into it, so monsters keep their ids for as
+// long as they live. popm() hands out the lowest free slot first, which keeps
+// the slots in use packed in below next_free_monster_id.
+constexpr int MON_SLOT_WORDS = (MON_TOTAL_ALLOCATIONS + 63) / 64;
+
+static thread_local uint64_t monster_free_slots[MON_SLOT_WORDS]; // only those below next_free_monster_id
+static thread_local int monster_free_count;
+
+// Empties the monster list, ready for a new level or a loaded game
+void monsterSlotsClear() {
+    for (auto &word : monster_free_slots) {
+        word = 0;
+    }
+    monster_free_count = 0;
+    next_free_monster_id = config::monsters::MON_MIN_INDEX_ID;
+}
+
+bool monsterSlotIsFree(int monster_id) {
+    return (monster_free_slots[monster_id >> 6] & ((uint64_t) 1 << (monster_id & 63))) != 0;
+}
+
+// Blanks the record of a deleted monster, and frees its slot
+void monsterSlotFree(int monster_id) {
+    monsters[monster_id] = blank_monster;
+    monster_free_slots[monster_id >> 6] |= (uint64_t) 1 << (monster_id & 63);
+    monster_free_count++;
+
+    // Free slots at the top go back to the end of the list
+    while (next_free_monster_id > config::monsters::MON_MIN_INDEX_ID && monsterSlotIsFree(next_free_monster_id - 1)) {
+        next_free_monster_id--;
+        monster_free_slots[next_free_monster_id >> 6] &= ~((uint64_t) 1 << (next_free_monster_id & 63));
+        monster_free_count--;
+    }
+}
+
+// How many more monsters there is room for
+int monsterSlotsLeft() {
+    return MON_TOTAL_ALLOCATIONS - next_free_monster_id + monster_free_count;
+}
+
+// Takes the lowest free slot, or -1 when there are none
+static int monsterSlotTake() {
+    if (monster_free_count == 0) {
+        return next_free_monster_id < MON_TOTAL_ALLOCATIONS ? next_free_monster_id++ : -1;
+    }
+
+    int word = 0;
+    while (monster_free_slots[word] == 0) {
+        word++;
+    }
+
+    int monster_id = word << 6;
+    for (uint64_t bits = monster_free_slots[word]; (bits & 1) == 0; bits >>= 1) {
+        monster_id++;
+    }
+
+    monster_free_slots[word] &= ~((uint64_t) 1 << (monster_id & 63));
+    monster_free_count--;
+
+    return monster_id;
+}
+
+// Spatial index of the monsters on the level. The dungeon is split into buckets
+// the size of a panel quadrant, each holding a linked list of the monsters that
+// are standing inside it, so finding the monsters near a spot only has to
+// look at the few buckets overlapping that area.
+constexpr int MON_INDEX_BUCKET_HEIGHT = SCREEN_HEIGHT / 2;
+constexpr int MON_INDEX_BUCKET_WIDTH = SCREEN_WIDTH / 2;
+constexpr int MON_INDEX_ROWS = MAX_HEIGHT / MON_INDEX_BUCKET_HEIGHT;
+constexpr int MON_INDEX_COLUMNS = MAX_WIDTH / MON_INDEX_BUCKET_WIDTH;
+
+static thread_local int16_t monster_index_heads[MON_INDEX_ROWS * MON_INDEX_COLUMNS];
+static thread_local int16_t monster_index_next[MON_TOTAL_ALLOCATIONS];
+static thread_local int16_t monster_index_prev[MON_TOTAL_ALLOCATIONS];
+static thread_local int16_t monster_index_bucket[MON_TOTAL_ALLOCATIONS]; // -1 when not indexed
+
+static int monsterIndexBucketAt(Coord_t const &coord) {
+    return (coord.y / MON_INDEX_BUCKET_HEIGHT) * MON_INDEX_COLUMNS + coord.x / MON_INDEX_BUCKET_WIDTH;
+}
+
+static void monsterIndexLink(int monster_id, int bucket) {
+    int16_t head = monster_index_heads[bucket];
+
+    monster_index_prev[monster_id] = -1;
+    monster_index_next[monster_id] = head;
+    if (head != -1) {
+        monster_index_prev[head] = (int16_t) monster_id;
+    }
+
+    monster_index_heads[bucket] = (int16_t) monster_id;
+    monster_index_bucket[monster_id] = (int16_t) bucket;
+}
+
+static void monsterIndexUnlink(int monster_id) {
+    int16_t prev = monster_index_prev[monster_id];
+    int16_t next = monster_index_next[monster_id];
+
+    if (prev != -1) {
+        monster_index_next[prev] = next;
+    } else {
+        monster_index_heads[monster_index_bucket[monster_id]] = next;
+    }
+
+    if (next != -1) {
+        monster_index_prev[next] = prev;
+    }
+
+    monster_index_bucket[monster_id] = -1;
+}
+
+// Empties the index, ready for a new level
+void monsterIndexClear() {
+    for (auto &head : monster_index_heads) {
+        head = -1;
+    }
+    for (auto &bucket : monster_index_bucket) {
+        bucket = -1;
+    }
+}
+
+// Rebuilds the index from the monster list, e.g. after loading a game
+void monsterIndexRebuild() {
+    monsterIndexClear();
+
+    for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+        if (!monsterSlotIsFree(id) && monsters[id].hp >= 0) {
+            monsterIndexAdd(id);
+        }
+    }
+}
+
+// Adds a monster to the index, at its current position
+void monsterIndexAdd(int monster_id) {
+    monsterIndexLink(monster_id, monsterIndexBucketAt(monsters[monster_id].pos));
+}
+
+// Removes a monster from the index, which is harmless if it isn't indexed
+void monsterIndexRemove(int monster_id) {
+    if (monster_index_bucket[monster_id] != -1) {
+        monsterIndexUnlink(monster_id);
+    }
+}
+
+// Updates the index for a monster that is moving to a new position
+void monsterIndexMove(int monster_id, Coord_t const &to) {
+    int bucket = monsterIndexBucketAt(to);
+
+    if (monster_index_bucket[monster_id] == bucket || monster_index_bucket[monster_id] == -1) {
+        return;
+    }
+
+    monsterIndexUnlink(monster_id);
+    monsterIndexLink(monster_id, bucket);
+}
+
+// Fills `ids` with the monsters standing inside the given area, and returns how many there are.
+// The ids are sorted highest first, the order in which the monster list is always walked.
+int monstersInArea(Coord_t const &top_left, Coord_t const &bottom_right, int16_t *ids) {
+    int top = std::max(top_left.y, 0) / MON_INDEX_BUCKET_HEIGHT;
+    int left = std::max(top_left.x, 0) / MON_INDEX_BUCKET_WIDTH;
+    int bottom = std::min(bottom_right.y, MAX_HEIGHT - 1) / MON_INDEX_BUCKET_HEIGHT;
+    int right = std::min(bottom_right.x, MAX_WIDTH - 1) / MON_INDEX_BUCKET_WIDTH;
+
+    int count = 0;
+
+    for (int row = top; row <= bottom; row++) {
+        for (int column = left; column <= right; column++) {
+            for (int id = monster_index_heads[row * MON_INDEX_COLUMNS + column]; id != -1; id = monster_index_next[id]) {
+                Coord_t const &pos = monsters[id].pos;
+
+                if (pos.y >= top_left.y && pos.y <= bottom_right.y && pos.x >= top_left.x && pos.x <= bottom_right.x) {
+                    ids[count++] = (int16_t) id;
+                }
+            }
+        }
+    }
+
+    std::sort(ids, ids + count, std::greater<int16_t>());
+
+    return count;
+}
+
+// Fills `ids` with the monsters within `distance` of `coord`, highest id first, and returns how many there are.
+int monstersWithinDistance(Coord_t const &coord, int distance, int16_t *ids) {
+    // coordDistanceBetween() is never less than the larger of the two axis distances
+    int count = monstersInArea(Coord_t{coord.y - distance, coord.x - distance}, Coord_t{coord.y + distance, coord.x + distance}, ids);
+
+    int within = 0;
+    for (int i = 0; i < count; i++) {
+        if (coordDistanceBetween(coord, monsters[ids[i]].pos) <= distance) {
+            ids[within++] = ids[i];
+        }
+    }
+
+    return within;
+}
+
+// Schedule of the monsters' turns. A monster out of reach of the player, too far
+// to be seen or to sense the player, not lit up and not stuck in rock, does
+// nothing on its turn but work out its distance from the player again. Such a
+// monster is parked, keyed in a heap by the number of steps the player has to
+// take before they could have come within its reach, and updateMonsters() walks
+// only the monsters still awake, which it finds from a bitset. The clock is the
+// player's steps rather than game turns, so while the player rests, searches or
+// fights in place, far off monsters stay parked for as long as that goes on.
+// Waking a monster early is always safe, so anything that could change what a
+// parked monster does wakes it. Free slots are passed over like parked monsters,
+// and so are monsters placed during a pass, until the next one: new monsters
+// used to go on the end of the list, which a pass had already been over.
+typedef struct {
+    int32_t step;
+    int16_t monster_id;
+} MonsterWake_t;
+
+constexpr int MON_SCHEDULE_HEAP_SIZE = MON_TOTAL_ALLOCATIONS * 2;
+
+static thread_local uint64_t monster_parked[MON_SLOT_WORDS];
+static thread_local uint64_t monster_held[MON_SLOT_WORDS]; // placed during this pass
+static thread_local bool monster_holding;
+static thread_local int32_t monster_wake_steps[MON_TOTAL_ALLOCATIONS];
+static thread_local MonsterWake_t monster_wake_heap[MON_SCHEDULE_HEAP_SIZE];
+static thread_local int monster_wake_heap_size;
+static thread_local Coord_t monster_schedule_player_pos;
+static thread_local int32_t monster_schedule_player_steps;
+
+// Heap entries for monsters since woken or renumbered are left in place, and
+// skipped once they come up, unless they still match a parked monster.
+static bool monsterWakeLater(MonsterWake_t const &a, MonsterWake_t const &b) {
+    return a.step > b.step;
+}
 
-int16_t next_free_monster_id;   // ID for the next available monster ptr
-int16_t monster_multiply_total; // Total number of reproduction's of creatures
+static bool monsterIsParked(int monster_id) {
+    return (monster_parked[monster_id >> 6] & ((uint64_t) 1 << (monster_id & 63))) != 0;
+}
+
+static void monsterWakePush(int monster_id) {
+    // When full, it is rebuilt from the parked monsters, which can fill at most half
+    if (monster_wake_heap_size == MON_SCHEDULE_HEAP_SIZE) {
+        monster_wake_heap_size = 0;
+
+        for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+            if (monsterIsParked(id)) {
+                monster_wake_heap[monster_wake_heap_size++] = MonsterWake_t{monster_wake_steps[id], (int16_t) id};
+            }
+        }
+
+        std::make_heap(monster_wake_heap, monster_wake_heap + monster_wake_heap_size, monsterWakeLater);
+    }
+
+    monster_wake_heap[monster_wake_heap_size++] = MonsterWake_t{monster_wake_steps[monster_id], (int16_t) monster_id};
+    std::push_heap(monster_wake_heap, monster_wake_heap + monster_wake_heap_size, monsterWakeLater);
+}
+
+// Wakes every monster, ready for a new level or a loaded game
+void monsterScheduleClear() {
+    for (auto &word : monster_parked) {
+        word = 0;
+    }
+    for (auto &word : monster_held) {
+        word = 0;
+    }
+    monster_holding = false;
+    monster_wake_heap_size = 0;
+}
+
+// Keeps a monster just placed from having a turn in the pass going on, if any
+static void monsterScheduleHold(int monster_id) {
+    monster_held[monster_id >> 6] |= (uint64_t) 1 << (monster_id & 63);
+    monster_holding = true;
+}
+
+// Puts a monster back on the schedule, with its distance from the player brought up to date
+void monsterScheduleWake(int monster_id) {
+    if (!monsterIsParked(monster_id)) {
+        return;
+    }
+
+    monster_parked[monster_id >> 6] &= ~((uint64_t) 1 << (monster_id & 63));
+
+    Monster_t &monster = monsters[monster_id];
+    monster.distance_from_player = (uint8_t) coordDistanceBetween(monster_schedule_player_pos, monster.pos);
+}
+
+// Wakes every parked monster, e.g. when the player turns up somewhere else
+void monsterScheduleWakeAll() {
+    for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+        monsterScheduleWake(id);
+    }
+    monster_wake_heap_size = 0;
+}
+
+// The player has taken a step to a square next to where they were
+void monsterSchedulePlayerStep() {
+    monster_schedule_player_steps++;
+}
+
+// Starts a pass of updateMonsters(), waking the monsters whose turn has come
+void monsterScheduleStartPass() {
+    monster_schedule_player_pos = py.pos;
+
+    if (monster_holding) {
+        for (auto &word : monster_held) {
+            word = 0;
+        }
+        monster_holding = false;
+    }
+
+    while (monster_wake_heap_size > 0 && monster_wake_heap[0].step <= monster_schedule_player_steps) {
+        std::pop_heap(monster_wake_heap, monster_wake_heap + monster_wake_heap_size, monsterWakeLater);
+        monster_wake_heap_size--;
+
+        MonsterWake_t const &wake = monster_wake_heap[monster_wake_heap_size];
+        if (monster_wake_steps[wake.monster_id] == wake.step) {
+            monsterScheduleWake(wake.monster_id);
+        }
+    }
+}
+
+// The awake monster to take its turn after `monster_id`, walking down from the
+// highest id, or -1 when there are none left.
+int monsterScheduleNext(int monster_id) {
+    int id = monster_id - 1;
+
+    while (id >= config::monsters::MON_MIN_INDEX_ID) {
+        // The ids of this word from `id` down, highest first, the rest counting as parked
+        int word = id >> 6;
+        int shift = 63 - (id & 63);
+        uint64_t parked = ((monster_parked[word] | monster_held[word] | monster_free_slots[word]) << shift) | (((uint64_t) 1 << shift) - 1);
+
+        if (parked == ~(uint64_t) 0) {
+            id = ((id >> 6) << 6) - 1;
+            continue;
+        }
+
+        while ((parked & ((uint64_t) 1 << 63)) != 0) {
+            parked <<= 1;
+            id--;
+        }
+
+        return id >= config::monsters::MON_MIN_INDEX_ID ? id : -1;
+    }
+
+    return -1;
+}
+
+// Parks a monster that has just had its turn, when it
+// can do nothing until the player comes nearer.
+void monsterSchedulePark(int monster_id) {
+    Monster_t const &monster = monsters[monster_id];
+    Creature_t const &creature = creatures_list[monster.creature_id];
+
+    if (monster.hp < 0 || monster.lit) {
+        return;
+    }
+
+    if ((creature.movement & config::monsters::move::CM_PHASE) == 0u && dg.floor[monster.pos.y][monster.pos.x].feature_id >= MIN_CAVE_WALL) {
+        return;
+    }
+
+    // A step of the player takes at most 2 off the distance
+    int reach = std::max((int) config::monsters::MON_MAX_SIGHT, (int) creature.area_affect_radius);
+    int steps = (monster.distance_from_player - reach + 1) / 2;
+
+    if (steps < 2) {
+        return;
+    }
+
+    monster_parked[monster_id >> 6] |= (uint64_t) 1 << (monster_id & 63);
+    monster_wake_steps[monster_id] = monster_schedule_player_steps + steps;
+    monsterWakePush(monster_id);
+}
 
 // Returns a pointer to next free space -RAK-
 // Returns -1 if could not allocate a monster.
 static int popm() {
-    if (next_free_monster_id == MON_TOTAL_ALLOCATIONS) {
-        if (!compactMonsters()) {
-            return -1;
-        }
+    if (monsterSlotsLeft() == 0 && !compactMonsters()) {
+        return -1;
     }
-    return next_free_monster_id++;
+
+    int monster_id = monsterSlotTake();
+    monsterScheduleHold(monster_id);
+
+    return monster_id;
 }
 
 // Places a monster at given location -RAK-
@@ -57,7 +434,8 @@ bool monsterPlaceNew(Coord_t coord, int creature_id, bool sleeping) {
     monster.distance_from_player = (uint8_t) coordDistanceBetween(py.pos, coord);
     monster.lit = false;
 
-    dg.floor[coord.y][coord.x].creature_id = (uint8_t) monster_id;
+    dg.floor[coord.y][coord.x].creature_id = (uint16_t) monster_id;
+    monsterIndexAdd(monster_id);
 
     if (sleeping) {
         if (creatures_list[creature_id].sleep_counter == 0) {
@@ -121,7 +499,8 @@ void monsterPlaceWinning() {
     monster.stunned_amount = 0;
     monster.distance_from_player = (uint8_t) coordDistanceBetween(py.pos, coord);
 
-    dg.floor[coord.y][coord.x].creature_id = (uint8_t) monster_id;
+    dg.floor[coord.y][coord.x].creature_id = (uint16_t) monster_id;
+    monsterIndexAdd(monster_id);
 
     monster.sleep_count = 0;
 }
@@ -249,40 +628,53 @@ bool monsterSummonUndead(Coord_t &coord) {
 }
 
 // Compact monsters -RAK-
+// Deletes the MON_COMPACT_COUNT monsters furthest from the player.
 // Return true if any monsters were deleted, false if could not delete any monsters.
 bool compactMonsters() {
     printMessage("Compacting monsters...");
 
-    int cur_dis = 66;
-
-    bool delete_any = false;
-    while (!delete_any) {
-        for (int i = next_free_monster_id - 1; i >= config::monsters::MON_MIN_INDEX_ID; i--) {
-            if (cur_dis < monsters[i].distance_from_player && randomNumber(3) == 1) {
-                if ((creatures_list[monsters[i].creature_id].movement & config::monsters::move::CM_WIN) != 0u) {
-                    // Never compact away the Balrog!!
-                } else if (hack_monptr < i) {
-                    // in case this is called from within updateMonsters(), this is a horrible
-                    // hack, the monsters/updateMonsters() code needs to be rewritten.
-                    dungeonDeleteMonster(i);
-                    delete_any = true;
-                } else {
-                    // dungeonDeleteMonsterFix1() does not decrement next_free_monster_id,
-                    // so don't set delete_any if this was called.
-                    dungeonDeleteMonsterFix1(i);
-                }
-            }
+    game.compactions.monsters++;
+
+    int distances[MON_TOTAL_ALLOCATIONS];
+    int16_t candidates[MON_TOTAL_ALLOCATIONS];
+    int count = 0;
+
+    for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+        Monster_t const &monster = monsters[id];
+
+        // Already dead, waiting for dungeonDeleteMonsterFix2()
+        if (monsterSlotIsFree(id) || monster.hp < 0) {
+            continue;
         }
 
-        if (!delete_any) {
-            cur_dis -= 6;
+        // Never compact away the Balrog!!
+        if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_WIN) != 0u) {
+            continue;
+        }
 
-            // Can't delete any monsters, return failure.
-            if (cur_dis < 0) {
-                return false;
-            }
+        // in case this is called from within updateMonsters(), the monster
+        // `hack_monptr` is in the middle of its turn, so leave it be.
+        if (id == hack_monptr) {
+            continue;
         }
+
+        distances[id] = coordDistanceBetween(py.pos, monster.pos);
+        candidates[count++] = (int16_t) id;
     }
 
-    return true;
+    // Furthest first, highest id first between equals
+    auto nearer = [&distances](int16_t a, int16_t b) { return distances[a] < distances[b] || (distances[a] == distances[b] && a < b); };
+
+    std::make_heap(candidates, candidates + count, nearer);
+
+    int total = 0;
+
+    while (total < config::monsters::MON_COMPACT_COUNT && count > 0) {
+        std::pop_heap(candidates, candidates + count, nearer);
+        count--;
+        dungeonDeleteMonster(candidates[count]);
+        total++;
+    }
+
+    return total > 0;
 }
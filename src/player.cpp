@@ -11,7 +11,7 @@
 #include "headers.h"
 
 // Player record for most player related info
-Player_t py = Player_t{};
+thread_local Player_t py = Player_t{};
 
 static void playerResetFlags() {
     py.flags.see_invisible = false;
@@ -375,7 +375,9 @@ void playerChangeSpeed(int speed) {
     py.flags.status |= config::player::status::PY_SPEED;
 
     for (int i = next_free_monster_id - 1; i >= config::monsters::MON_MIN_INDEX_ID; i--) {
-        monsters[i].speed += speed;
+        if (!monsterSlotIsFree(i)) {
+            monsters[i].speed += speed;
+        }
     }
 }
 
@@ -1218,7 +1220,7 @@ static int16_t playerLockPickingSkill() {
 }
 
 static void openClosedDoor(Coord_t coord) {
-    Tile_t &tile = dg.floor[coord.y][coord.x];
+    Tile_t tile = dg.floor[coord.y][coord.x];
     Inventory_t &item = game.treasure.list[tile.treasure_id];
 
     if (item.misc_use > 0) {
@@ -1243,6 +1245,7 @@ static void openClosedDoor(Coord_t coord) {
     if (item.misc_use == 0) {
         inventoryItemCopyTo(config::dungeon::objects::OBJ_OPEN_DOOR, game.treasure.list[tile.treasure_id]);
         tile.feature_id = TILE_CORR_FLOOR;
+        losCacheInvalidate();
         dungeonLiteSpot(coord);
         game.command_count = 0;
     }
@@ -1344,7 +1347,7 @@ void playerCloseDoor() {
     Coord_t coord = py.pos;
     (void) playerMovePosition(dir, coord);
 
-    Tile_t &tile = dg.floor[coord.y][coord.x];
+    Tile_t tile = dg.floor[coord.y][coord.x];
     Inventory_t &item = game.treasure.list[tile.treasure_id];
 
     bool no_object = false;
@@ -1355,6 +1358,7 @@ void playerCloseDoor() {
                 if (item.misc_use == 0) {
                     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, item);
                     tile.feature_id = TILE_BLOCKED_FLOOR;
+                    losCacheInvalidate();
                     dungeonLiteSpot(coord);
                 } else {
                     printMessage("The door appears to be broken.");
@@ -1382,7 +1386,7 @@ bool playerTunnelWall(Coord_t coord, int digging_ability, int digging_chance) {
         return false;
     }
 
-    Tile_t &tile = dg.floor[coord.y][coord.x];
+    Tile_t tile = dg.floor[coord.y][coord.x];
 
     if (tile.perma_lit_room) {
         // Should become a room space, check to see whether
@@ -1409,6 +1413,7 @@ bool playerTunnelWall(Coord_t coord, int digging_ability, int digging_chance) {
         tile.feature_id = TILE_CORR_FLOOR;
         tile.permanent_light = false;
     }
+    losCacheInvalidate();
 
     tile.field_mark = false;
 
@@ -179,7 +179,7 @@ typedef struct {
     bool carrying_light = false;  // `true` when player is carrying light
 } Player_t;
 
-extern Player_t py;
+extern thread_local Player_t py;
 
 extern ClassRankTitle_t class_rank_titles[PLAYER_MAX_CLASSES][PLAYER_MAX_LEVEL];
 extern Race_t character_races[PLAYER_MAX_RACES];
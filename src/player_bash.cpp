@@ -13,7 +13,7 @@
 
 static void playerBashAttack(Coord_t coord);
 static void playerBashPosition(Coord_t coord);
-static void playerBashClosedDoor(Coord_t coord, int dir, Tile_t &tile, Inventory_t &item);
+static void playerBashClosedDoor(Coord_t coord, int dir, Tile_t tile, Inventory_t &item);
 static void playerBashClosedChest(Inventory_t &item);
 
 // Bash open a door or chest -RAK-
@@ -49,7 +49,7 @@ void playerBash() {
     Coord_t coord = py.pos;
     (void) playerMovePosition(dir, coord);
 
-    Tile_t &tile = dg.floor[coord.y][coord.x];
+    Tile_t tile = dg.floor[coord.y][coord.x];
 
     if (tile.creature_id > 1) {
         playerBashPosition(coord);
@@ -173,7 +173,7 @@ static void playerBashPosition(Coord_t coord) {
     playerBashAttack(coord);
 }
 
-static void playerBashClosedDoor(Coord_t coord, int dir, Tile_t &tile, Inventory_t &item) {
+static void playerBashClosedDoor(Coord_t coord, int dir, Tile_t tile, Inventory_t &item) {
     printMessageNoCommandInterrupt("You smash into the door!");
 
     int chance = py.stats.used[PlayerAttr::A_STR] + py.misc.weight / 2;
@@ -189,6 +189,7 @@ static void playerBashClosedDoor(Coord_t coord, int dir, Tile_t &tile, Inventory
         item.misc_use = (int16_t)(1 - randomNumber(2));
 
         tile.feature_id = TILE_CORR_FLOOR;
+        losCacheInvalidate();
 
         if (py.flags.confused == 0) {
             playerMove(dir, false);
@@ -11,11 +11,11 @@
 #include "headers.h"
 
 // Monster memories
-Recall_t creature_recall[MON_MAX_CREATURES];
+thread_local Recall_t creature_recall[MON_MAX_CREATURES];
 
-static vtype_t roff_buffer = {'\0'};        // Line buffer.
-static char *roff_buffer_pointer = nullptr; // Pointer into line buffer.
-static int roff_print_line;                 // Place to print line now being loaded.
+static thread_local vtype_t roff_buffer = {'\0'};        // Line buffer.
+static thread_local char *roff_buffer_pointer = nullptr; // Pointer into line buffer.
+static thread_local int roff_print_line;                 // Place to print line now being loaded.
 
 #define plural(c, ss, sp) ((c) == 1 ? (ss) : (sp))
 
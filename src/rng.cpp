@@ -66,7 +66,7 @@ constexpr int32_t RNG_Q = RNG_M / RNG_A; // m div a 127773L
 constexpr int32_t RNG_R = RNG_M % RNG_A; // m mod a 2836L
 
 // 32 bit seed
-static uint32_t rnd_seed;
+static thread_local uint32_t rnd_seed;
 
 uint32_t getRandomSeed() {
     return rnd_seed;
@@ -160,7 +160,7 @@ bool spellDetectTreasureWithinVicinity() {
 
     for (coord.y = dg.panel.top; coord.y <= dg.panel.bottom; coord.y++) {
         for (coord.x = dg.panel.left; coord.x <= dg.panel.right; coord.x++) {
-            Tile_t &tile = dg.floor[coord.y][coord.x];
+            Tile_t tile = dg.floor[coord.y][coord.x];
 
             if (tile.treasure_id != 0 && game.treasure.list[tile.treasure_id].category_id == TV_GOLD && !caveTileVisible(coord)) {
                 tile.field_mark = true;
@@ -181,7 +181,7 @@ bool spellDetectObjectsWithinVicinity() {
 
     for (coord.y = dg.panel.top; coord.y <= dg.panel.bottom; coord.y++) {
         for (coord.x = dg.panel.left; coord.x <= dg.panel.right; coord.x++) {
-            Tile_t &tile = dg.floor[coord.y][coord.x];
+            Tile_t tile = dg.floor[coord.y][coord.x];
 
             if (tile.treasure_id != 0 && game.treasure.list[tile.treasure_id].category_id < TV_MAX_OBJECT && !caveTileVisible(coord)) {
                 tile.field_mark = true;
@@ -202,7 +202,7 @@ bool spellDetectTrapsWithinVicinity() {
 
     for (coord.y = dg.panel.top; coord.y <= dg.panel.bottom; coord.y++) {
         for (coord.x = dg.panel.left; coord.x <= dg.panel.right; coord.x++) {
-            Tile_t &tile = dg.floor[coord.y][coord.x];
+            Tile_t tile = dg.floor[coord.y][coord.x];
 
             if (tile.treasure_id == 0) {
                 continue;
@@ -230,7 +230,7 @@ bool spellDetectSecretDoorssWithinVicinity() {
 
     for (coord.y = dg.panel.top; coord.y <= dg.panel.bottom; coord.y++) {
         for (coord.x = dg.panel.left; coord.x <= dg.panel.right; coord.x++) {
-            Tile_t &tile = dg.floor[coord.y][coord.x];
+            Tile_t tile = dg.floor[coord.y][coord.x];
 
             if (tile.treasure_id == 0) {
                 continue;
@@ -259,11 +259,17 @@ bool spellDetectSecretDoorssWithinVicinity() {
 bool spellDetectInvisibleCreaturesWithinVicinity() {
     bool detected = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersInArea(Coord_t{dg.panel.top, dg.panel.left}, Coord_t{dg.panel.bottom, dg.panel.right}, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
 
-        if (coordInsidePanel(Coord_t{monster.pos.y, monster.pos.x}) && ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) != 0u)) {
+        if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) != 0u) {
             monster.lit = true;
+            floorGlyphForget(monster.pos);
+            monsterScheduleWake(id);
 
             // works correctly even if hallucinating
             panelPutTile((char) creatures_list[monster.creature_id].sprite, Coord_t{monster.pos.y, monster.pos.x});
@@ -302,8 +308,10 @@ bool spellLightArea(Coord_t coord) {
     // the edge of a room, or next to a destroyed area, etc.
     Coord_t spot = Coord_t{0, 0};
     for (spot.y = coord.y - 1; spot.y <= coord.y + 1; spot.y++) {
+        floorFlagSetRun(dg.floor.permanent_lights[spot.y], coord.x - 1, coord.x + 1, true);
+        floorGlyphsForgetRun(spot.y, coord.x - 1, coord.x + 1);
+
         for (spot.x = coord.x - 1; spot.x <= coord.x + 1; spot.x++) {
-            dg.floor[spot.y][spot.x].permanent_light = true;
             dungeonLiteSpot(spot);
         }
     }
@@ -322,36 +330,42 @@ bool spellDarkenArea(Coord_t coord) {
         int half_width = (SCREEN_WIDTH / 2);
         int start_row = (coord.y / half_height) * half_height + 1;
         int start_col = (coord.x / half_width) * half_width + 1;
-        int end_row = start_row + half_height - 1;
-        int end_col = start_col + half_width - 1;
+        int end_row = std::min(start_row + half_height - 1, dg.height - 1);
+        int end_col = std::min(start_col + half_width - 1, dg.width - 1);
 
         for (spot.y = start_row; spot.y <= end_row; spot.y++) {
-            for (spot.x = start_col; spot.x <= end_col; spot.x++) {
-                Tile_t &tile = dg.floor[spot.y][spot.x];
+            uint64_t room[FLOOR_ROW_WORDS];
+            floorRowFeatureMask(room, spot.y, start_col, end_col, 0, MAX_CAVE_FLOOR);
 
-                if (tile.perma_lit_room && tile.feature_id <= MAX_CAVE_FLOOR) {
-                    tile.permanent_light = false;
-                    tile.feature_id = TILE_DARK_FLOOR;
+            for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+                room[word] &= dg.floor.perma_lit_rooms[spot.y][word];
+                dg.floor.permanent_lights[spot.y][word] &= ~room[word];
+            }
+            floorGlyphsForget(spot.y, room);
 
-                    dungeonLiteSpot(spot);
+            for (spot.x = floorRowNextTile(room, start_col); spot.x <= end_col; spot.x = floorRowNextTile(room, spot.x + 1)) {
+                dg.floor[spot.y][spot.x].feature_id = TILE_DARK_FLOOR;
 
-                    if (!caveTileVisible(spot)) {
-                        darkened = true;
-                    }
+                dungeonLiteSpot(spot);
+
+                if (!caveTileVisible(spot)) {
+                    darkened = true;
                 }
             }
         }
     } else {
         for (spot.y = coord.y - 1; spot.y <= coord.y + 1; spot.y++) {
-            for (spot.x = coord.x - 1; spot.x <= coord.x + 1; spot.x++) {
-                Tile_t &tile = dg.floor[spot.y][spot.x];
+            uint64_t corridor[FLOOR_ROW_WORDS];
+            floorRowFeatureMask(corridor, spot.y, coord.x - 1, coord.x + 1, TILE_CORR_FLOOR, TILE_CORR_FLOOR);
 
-                if (tile.feature_id == TILE_CORR_FLOOR && tile.permanent_light) {
-                    // permanent_light could have been set by star-lite wand, etc
-                    tile.permanent_light = false;
+            for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+                // permanent_light could have been set by star-lite wand, etc
+                if ((corridor[word] & dg.floor.permanent_lights[spot.y][word]) != 0) {
+                    dg.floor.permanent_lights[spot.y][word] &= ~corridor[word];
                     darkened = true;
                 }
             }
+            floorGlyphsForget(spot.y, corridor);
         }
     }
 
@@ -362,23 +376,6 @@ bool spellDarkenArea(Coord_t coord) {
     return darkened;
 }
 
-static void dungeonLightAreaAroundFloorTile(Coord_t coord) {
-    Coord_t spot = Coord_t{0, 0};
-
-    for (spot.y = coord.y - 1; spot.y <= coord.y + 1; spot.y++) {
-        for (spot.x = coord.x - 1; spot.x <= coord.x + 1; spot.x++) {
-            Tile_t &tile = dg.floor[spot.y][spot.x];
-
-            if (tile.feature_id >= MIN_CAVE_WALL) {
-                tile.permanent_light = true;
-            } else if (tile.treasure_id != 0 && game.treasure.list[tile.treasure_id].category_id >= TV_MIN_VISIBLE &&
-                       game.treasure.list[tile.treasure_id].category_id <= TV_MAX_VISIBLE) {
-                tile.field_mark = true;
-            }
-        }
-    }
-}
-
 // Map the current area plus some -RAK-
 void spellMapCurrentArea() {
     int row_min = dg.panel.top - randomNumber(10);
@@ -386,17 +383,60 @@ void spellMapCurrentArea() {
     int col_min = dg.panel.left - randomNumber(20);
     int col_max = dg.panel.right + randomNumber(20);
 
+    // Only in bounds floor tiles are mapped around
+    row_min = std::max(row_min, 1);
+    row_max = std::min(row_max, dg.height - 2);
+    col_min = std::max(col_min, 1);
+    col_max = std::min(col_max, dg.width - 2);
+
+    // The floor tiles, and those next to them, for each row
+    uint64_t around[MAX_HEIGHT][FLOOR_ROW_WORDS] = {};
+
+    for (int y = row_min; y <= row_max; y++) {
+        uint64_t floors[FLOOR_ROW_WORDS];
+        floorRowFeatureMask(floors, y, col_min, col_max, 0, MAX_CAVE_FLOOR);
+        floorRowSpread(floors);
+
+        for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+            around[y - 1][word] |= floors[word];
+            around[y][word] |= floors[word];
+            around[y + 1][word] |= floors[word];
+        }
+    }
+
+    // Walls light up, and visible objects get a field mark.
+    // The screen only needs redrawing where that changed.
     Coord_t coord = Coord_t{0, 0};
 
-    for (coord.y = row_min; coord.y <= row_max; coord.y++) {
-        for (coord.x = col_min; coord.x <= col_max; coord.x++) {
-            if (coordInBounds(coord) && dg.floor[coord.y][coord.x].feature_id <= MAX_CAVE_FLOOR) {
-                dungeonLightAreaAroundFloorTile(coord);
+    for (coord.y = row_min - 1; coord.y <= row_max + 1; coord.y++) {
+        uint64_t walls[FLOOR_ROW_WORDS];
+        floorRowFeatureMask(walls, coord.y, 0, MAX_WIDTH - 1, MIN_CAVE_WALL, UINT8_MAX);
+
+        uint64_t changed[FLOOR_ROW_WORDS];
+        for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+            uint64_t old_lights = dg.floor.permanent_lights[coord.y][word];
+            dg.floor.permanent_lights[coord.y][word] |= around[coord.y][word] & walls[word];
+            changed[word] = dg.floor.permanent_lights[coord.y][word] ^ old_lights;
+
+            around[coord.y][word] &= ~walls[word];
+        }
+
+        for (coord.x = floorRowNextTile(around[coord.y], 0); coord.x < MAX_WIDTH; coord.x = floorRowNextTile(around[coord.y], coord.x + 1)) {
+            Tile_t tile = dg.floor[coord.y][coord.x];
+
+            if (!tile.field_mark && tile.treasure_id != 0 && game.treasure.list[tile.treasure_id].category_id >= TV_MIN_VISIBLE &&
+                game.treasure.list[tile.treasure_id].category_id <= TV_MAX_VISIBLE) {
+                tile.field_mark = true;
+                changed[coord.x >> 6] |= (uint64_t) 1 << (coord.x & 63);
             }
         }
-    }
 
-    drawDungeonPanel();
+        floorGlyphsForget(coord.y, changed);
+
+        for (coord.x = floorRowNextTile(changed, 0); coord.x < MAX_WIDTH; coord.x = floorRowNextTile(changed, coord.x + 1)) {
+            dungeonLiteSpot(coord);
+        }
+    }
 }
 
 // Identify an object -RAK-
@@ -430,7 +470,14 @@ bool spellIdentifyItem() {
 bool spellAggravateMonsters(int affect_distance) {
     bool aggravated = false;
 
+    // Brings the distances of parked monsters up to date
+    monsterScheduleWakeAll();
+
     for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+        if (monsterSlotIsFree(id)) {
+            continue;
+        }
+
         Monster_t &monster = monsters[id];
         monster.sleep_count = 0;
 
@@ -496,7 +543,7 @@ bool spellSurroundPlayerWithDoors() {
                 continue;
             }
 
-            Tile_t &tile = dg.floor[coord.y][coord.x];
+            Tile_t tile = dg.floor[coord.y][coord.x];
 
             if (tile.feature_id <= MAX_CAVE_FLOOR) {
                 if (tile.treasure_id != 0) {
@@ -505,7 +552,8 @@ bool spellSurroundPlayerWithDoors() {
 
                 int free_id = popt();
                 tile.feature_id = TILE_BLOCKED_FLOOR;
-                tile.treasure_id = (uint8_t) free_id;
+                treasurePutOnTile(coord, free_id);
+                losCacheInvalidate();
 
                 inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, game.treasure.list[free_id]);
                 dungeonLiteSpot(coord);
@@ -558,11 +606,17 @@ bool spellDestroyAdjacentDoorsTraps() {
 bool spellDetectMonsters() {
     bool detected = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersInArea(Coord_t{dg.panel.top, dg.panel.left}, Coord_t{dg.panel.bottom, dg.panel.right}, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
 
-        if (coordInsidePanel(Coord_t{monster.pos.y, monster.pos.x}) && (creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) == 0) {
+        if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) == 0) {
             monster.lit = true;
+            floorGlyphForget(monster.pos);
+            monsterScheduleWake(id);
             detected = true;
 
             // works correctly even if hallucinating
@@ -613,7 +667,7 @@ void spellLightLine(Coord_t coord, int direction) {
     Coord_t tmp_coord = Coord_t{0, 0};
 
     while (!finished) {
-        Tile_t &tile = dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
         if (distance > config::treasure::OBJECT_BOLTS_MAX_RANGE || tile.feature_id >= MIN_CLOSED_SPACE) {
             (void) playerMovePosition(direction, coord);
@@ -669,15 +723,15 @@ bool spellDisarmAllInDirection(Coord_t coord, int direction) {
     int distance = 0;
     bool disarmed = false;
 
-    Tile_t *tile = nullptr;
+    bool open_space;
 
     do {
-        tile = &dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
         // note, must continue up to and including the first non open space,
         // because secret doors have feature_id greater than MAX_OPEN_SPACE
-        if (tile->treasure_id != 0) {
-            Inventory_t &item = game.treasure.list[tile->treasure_id];
+        if (tile.treasure_id != 0) {
+            Inventory_t &item = game.treasure.list[tile.treasure_id];
 
             if (item.category_id == TV_INVIS_TRAP || item.category_id == TV_VIS_TRAP) {
                 if (dungeonDeleteObject(coord)) {
@@ -687,7 +741,7 @@ bool spellDisarmAllInDirection(Coord_t coord, int direction) {
                 // Locked or jammed doors become merely closed.
                 item.misc_use = 0;
             } else if (item.category_id == TV_SECRET_DOOR) {
-                tile->field_mark = true;
+                tile.field_mark = true;
                 trapChangeVisibility(coord);
                 disarmed = true;
             } else if (item.category_id == TV_CHEST && item.flags != 0) {
@@ -701,11 +755,13 @@ bool spellDisarmAllInDirection(Coord_t coord, int direction) {
             }
         }
 
+        open_space = tile.feature_id <= MAX_OPEN_SPACE;
+
         // move must be at end because want to light up current spot
         (void) playerMovePosition(direction, coord);
 
         distance++;
-    } while (distance <= config::treasure::OBJECT_BOLTS_MAX_RANGE && tile->feature_id <= MAX_OPEN_SPACE);
+    } while (distance <= config::treasure::OBJECT_BOLTS_MAX_RANGE && open_space);
 
     return disarmed;
 }
@@ -765,7 +821,7 @@ static void printBoltStrikesMonsterMessage(Creature_t const &creature, const std
 }
 
 // Light up, draw, and check for monster damage when Fire Bolt touches it.
-static void spellFireBoltTouchesMonster(Tile_t &tile, int damage, int harm_type, uint32_t weapon_id, const std::string &bolt_name) {
+static void spellFireBoltTouchesMonster(Tile_t tile, int damage, int harm_type, uint32_t weapon_id, const std::string &bolt_name) {
     Monster_t const &monster = monsters[tile.creature_id];
     Creature_t const &creature = creatures_list[monster.creature_id];
 
@@ -822,7 +878,7 @@ void spellFireBolt(Coord_t coord, int direction, int damage_hp, int spell_type,
 
         distance++;
 
-        Tile_t &tile = dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
         dungeonLiteSpot(old_coord);
 
@@ -874,12 +930,12 @@ void spellFireBall(Coord_t coord, int direction, int damage_hp, int spell_type,
             continue;
         }
 
-        Tile_t *tile = &dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
-        if (tile->feature_id >= MIN_CLOSED_SPACE || tile->creature_id > 1) {
+        if (tile.feature_id >= MIN_CLOSED_SPACE || tile.creature_id > 1) {
             finished = true;
 
-            if (tile->feature_id >= MIN_CLOSED_SPACE) {
+            if (tile.feature_id >= MIN_CLOSED_SPACE) {
                 coord.y = old_coord.y;
                 coord.x = old_coord.x;
             }
@@ -893,21 +949,21 @@ void spellFireBall(Coord_t coord, int direction, int damage_hp, int spell_type,
                     spot.x = col;
 
                     if (coordInBounds(spot) && coordDistanceBetween(coord, spot) <= max_distance && los(coord, spot)) {
-                        tile = &dg.floor[spot.y][spot.x];
+                        Tile_t spot_tile = dg.floor[spot.y][spot.x];
 
-                        if (tile->treasure_id != 0 && (*destroy)(&game.treasure.list[tile->treasure_id])) {
+                        if (spot_tile.treasure_id != 0 && (*destroy)(&game.treasure.list[spot_tile.treasure_id])) {
                             (void) dungeonDeleteObject(spot);
                         }
 
-                        if (tile->feature_id <= MAX_OPEN_SPACE) {
-                            if (tile->creature_id > 1) {
-                                Monster_t const &monster = monsters[tile->creature_id];
+                        if (spot_tile.feature_id <= MAX_OPEN_SPACE) {
+                            if (spot_tile.creature_id > 1) {
+                                Monster_t const &monster = monsters[spot_tile.creature_id];
                                 Creature_t const &creature = creatures_list[monster.creature_id];
 
                                 // lite up creature if visible, temp set permanent_light so that monsterUpdateVisibility works
-                                bool saved_lit_status = tile->permanent_light;
-                                tile->permanent_light = true;
-                                monsterUpdateVisibility((int) tile->creature_id);
+                                bool saved_lit_status = spot_tile.permanent_light;
+                                spot_tile.permanent_light = true;
+                                monsterUpdateVisibility((int) spot_tile.creature_id);
 
                                 total_hits++;
                                 int damage = damage_hp;
@@ -926,10 +982,10 @@ void spellFireBall(Coord_t coord, int direction, int damage_hp, int spell_type,
 
                                 damage = (damage / (coordDistanceBetween(spot, coord) + 1));
 
-                                if (monsterTakeHit((int) tile->creature_id, damage) >= 0) {
+                                if (monsterTakeHit((int) spot_tile.creature_id, damage) >= 0) {
                                     total_kills++;
                                 }
-                                tile->permanent_light = saved_lit_status;
+                                spot_tile.permanent_light = saved_lit_status;
                             } else if (coordInsidePanel(spot) && py.flags.blind < 1) {
                                 panelPutTile('*', spot);
                             }
@@ -1038,13 +1094,11 @@ void spellBreath(Coord_t coord, int monster_id, int damage_hp, int spell_type, c
                                     (uint32_t)(treasure_id | (creature_recall[monster.creature_id].movement & ~config::monsters::move::CM_TREASURE));
                             }
 
-                            // It ate an already processed monster. Handle normally.
-                            if (monster_id < tile.creature_id) {
+                            // The breather can be caught in its own breath, and updateMonsters()
+                            // still has its record in hand, so its slot is freed after its turn.
+                            if (tile.creature_id != monster_id) {
                                 dungeonDeleteMonster((int) tile.creature_id);
                             } else {
-                                // If it eats this monster, an already processed monster
-                                // will take its place, causing all kinds of havoc.
-                                // Delay the kill a bit.
                                 dungeonDeleteMonsterFix1((int) tile.creature_id);
                             }
                         }
@@ -1458,17 +1512,17 @@ bool spellDestroyDoorsTrapsInDirection(Coord_t coord, int direction) {
     bool destroyed = false;
     int distance = 0;
 
-    Tile_t *tile = nullptr;
+    bool open_space;
 
     do {
         (void) playerMovePosition(direction, coord);
         distance++;
 
-        tile = &dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
         // must move into first closed spot, as it might be a secret door
-        if (tile->treasure_id != 0) {
-            Inventory_t &item = game.treasure.list[tile->treasure_id];
+        if (tile.treasure_id != 0) {
+            Inventory_t &item = game.treasure.list[tile.treasure_id];
 
             if (item.category_id == TV_INVIS_TRAP || item.category_id == TV_CLOSED_DOOR || item.category_id == TV_VIS_TRAP || item.category_id == TV_OPEN_DOOR ||
                 item.category_id == TV_SECRET_DOOR) {
@@ -1486,7 +1540,9 @@ bool spellDestroyDoorsTrapsInDirection(Coord_t coord, int direction) {
                 spellItemIdentifyAndRemoveRandomInscription(item);
             }
         }
-    } while ((distance <= config::treasure::OBJECT_BOLTS_MAX_RANGE) || tile->feature_id <= MAX_OPEN_SPACE);
+
+        open_space = tile.feature_id <= MAX_OPEN_SPACE;
+    } while ((distance <= config::treasure::OBJECT_BOLTS_MAX_RANGE) || open_space);
 
     return destroyed;
 }
@@ -1545,7 +1601,7 @@ bool spellBuildWall(Coord_t coord, int direction) {
         (void) playerMovePosition(direction, coord);
         distance++;
 
-        Tile_t &tile = dg.floor[coord.y][coord.x];
+        Tile_t tile = dg.floor[coord.y][coord.x];
 
         if (distance > config::treasure::OBJECT_BOLTS_MAX_RANGE || tile.feature_id >= MIN_CLOSED_SPACE) {
             finished = true;
@@ -1589,6 +1645,7 @@ bool spellBuildWall(Coord_t coord, int direction) {
 
         tile.feature_id = TILE_MAGMA_WALL;
         tile.field_mark = false;
+        losCacheInvalidate();
 
         // Permanently light this wall if it is lit by player's lamp.
         tile.permanent_light = (tile.temporary_light || tile.permanent_light);
@@ -1653,6 +1710,7 @@ void spellTeleportAwayMonster(int monster_id, int distance_from_player) {
     // this is necessary, because the creature is
     // not currently visible in its new position.
     monster.lit = false;
+    floorGlyphForget(monster.pos);
     monster.distance_from_player = (uint8_t) coordDistanceBetween(py.pos, coord);
 
     monsterUpdateVisibility(monster_id);
@@ -1731,11 +1789,15 @@ bool spellTeleportAwayMonsterInDirection(Coord_t coord, int direction) {
 bool spellMassGenocide() {
     bool killed = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(py.pos, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t const &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && (creature.movement & config::monsters::move::CM_WIN) == 0) {
+        if ((creature.movement & config::monsters::move::CM_WIN) == 0) {
             killed = true;
             dungeonDeleteMonster(id);
         }
@@ -1756,6 +1818,10 @@ bool spellGenocide() {
     bool killed = false;
 
     for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+        if (monsterSlotIsFree(id)) {
+            continue;
+        }
+
         Monster_t const &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
@@ -1780,13 +1846,17 @@ bool spellGenocide() {
 bool spellSpeedAllMonsters(int speed) {
     bool speedy = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(py.pos, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
         auto name = monsterNameDescription(creature.name, monster.lit);
 
-        if (monster.distance_from_player > config::monsters::MON_MAX_SIGHT || !los(py.pos, monster.pos)) {
+        if (!losFromPlayer(monster.pos)) {
             continue; // do nothing
         }
 
@@ -1819,13 +1889,17 @@ bool spellSpeedAllMonsters(int speed) {
 bool spellSleepAllMonsters() {
     bool asleep = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(py.pos, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
         auto name = monsterNameDescription(creature.name, monster.lit);
 
-        if (monster.distance_from_player > config::monsters::MON_MAX_SIGHT || !los(py.pos, monster.pos)) {
+        if (!losFromPlayer(monster.pos)) {
             continue; // do nothing
         }
 
@@ -1854,20 +1928,21 @@ bool spellMassPolymorph() {
     bool morphed = false;
     Coord_t coord = Coord_t{0, 0};
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
-        Monster_t const &monster = monsters[id];
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(py.pos, config::monsters::MON_MAX_SIGHT, ids);
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT) {
-            Creature_t const &creature = creatures_list[monster.creature_id];
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
+        Monster_t const &monster = monsters[id];
+        Creature_t const &creature = creatures_list[monster.creature_id];
 
-            if ((creature.movement & config::monsters::move::CM_WIN) == 0) {
-                coord.y = monster.pos.y;
-                coord.x = monster.pos.x;
-                dungeonDeleteMonster(id);
+        if ((creature.movement & config::monsters::move::CM_WIN) == 0) {
+            coord.y = monster.pos.y;
+            coord.x = monster.pos.x;
+            dungeonDeleteMonster(id);
 
-                // Place_monster() should always return true here.
-                morphed = monsterPlaceNew(coord, randomNumber(monster_levels[MON_MAX_LEVELS] - monster_levels[0]) - 1 + monster_levels[0], false);
-            }
+            // Place_monster() should always return true here.
+            morphed = monsterPlaceNew(coord, randomNumber(monster_levels[MON_MAX_LEVELS] - monster_levels[0]) - 1 + monster_levels[0], false);
         }
     }
 
@@ -1878,11 +1953,17 @@ bool spellMassPolymorph() {
 bool spellDetectEvil() {
     bool detected = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersInArea(Coord_t{dg.panel.top, dg.panel.left}, Coord_t{dg.panel.bottom, dg.panel.right}, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
 
-        if (coordInsidePanel(Coord_t{monster.pos.y, monster.pos.x}) && ((creatures_list[monster.creature_id].defenses & config::monsters::defense::CD_EVIL) != 0)) {
+        if ((creatures_list[monster.creature_id].defenses & config::monsters::defense::CD_EVIL) != 0) {
             monster.lit = true;
+            floorGlyphForget(monster.pos);
+            monsterScheduleWake(id);
 
             detected = true;
 
@@ -1971,7 +2052,7 @@ void spellEarthquake() {
     for (coord.y = py.pos.y - 8; coord.y <= py.pos.y + 8; coord.y++) {
         for (coord.x = py.pos.x - 8; coord.x <= py.pos.x + 8; coord.x++) {
             if ((coord.y != py.pos.y || coord.x != py.pos.x) && coordInBounds(coord) && randomNumber(8) == 1) {
-                Tile_t &tile = dg.floor[coord.y][coord.x];
+                Tile_t tile = dg.floor[coord.y][coord.x];
 
                 if (tile.treasure_id != 0) {
                     (void) dungeonDeleteObject(coord);
@@ -1998,6 +2079,7 @@ void spellEarthquake() {
 
                     tile.field_mark = false;
                 }
+                losCacheInvalidate();
                 dungeonLiteSpot(coord);
             }
         }
@@ -2022,6 +2104,7 @@ void spellCreateFood() {
 
     dungeonPlaceRandomObjectAt(py.pos, false);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_MUSH, game.treasure.list[tile.treasure_id]);
+    floorGlyphForget(py.pos);
 }
 
 // Attempts to destroy a type of creature.  Success depends on
@@ -2029,11 +2112,14 @@ void spellCreateFood() {
 bool spellDispelCreature(int creature_defense, int damage) {
     bool dispelled = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(py.pos, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t const &monster = monsters[id];
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && ((creature_defense & creatures_list[monster.creature_id].defenses) != 0) &&
-            los(py.pos, monster.pos)) {
+        if (((creature_defense & creatures_list[monster.creature_id].defenses) != 0) && losFromPlayer(monster.pos)) {
             Creature_t const &creature = creatures_list[monster.creature_id];
 
             creature_recall[monster.creature_id].defenses |= creature_defense;
@@ -2064,11 +2150,15 @@ bool spellDispelCreature(int creature_defense, int damage) {
 bool spellTurnUndead() {
     bool turned = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(py.pos, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && ((creature.defenses & config::monsters::defense::CD_UNDEAD) != 0) && los(py.pos, monster.pos)) {
+        if (((creature.defenses & config::monsters::defense::CD_UNDEAD) != 0) && losFromPlayer(monster.pos)) {
             auto name = monsterNameDescription(creature.name, monster.lit);
 
             if (py.misc.level + 1 > creature.level || randomNumber(5) == 1) {
@@ -2094,7 +2184,7 @@ bool spellTurnUndead() {
 void spellWardingGlyph() {
     if (dg.floor[py.pos.y][py.pos.x].treasure_id == 0) {
         int free_id = popt();
-        dg.floor[py.pos.y][py.pos.x].treasure_id = (uint8_t) free_id;
+        treasurePutOnTile(py.pos, free_id);
         inventoryItemCopyTo(config::dungeon::objects::OBJ_SCARE_MON, game.treasure.list[free_id]);
     }
 }
@@ -2210,7 +2300,7 @@ bool spellSlowPoison() {
 }
 
 static void replaceSpot(Coord_t coord, int typ) {
-    Tile_t &tile = dg.floor[coord.y][coord.x];
+    Tile_t tile = dg.floor[coord.y][coord.x];
 
     switch (typ) {
         case 1:
@@ -2236,6 +2326,7 @@ static void replaceSpot(Coord_t coord, int typ) {
         default:
             break;
     }
+    losCacheInvalidate();
 
     tile.permanent_light = false;
     tile.field_mark = false;
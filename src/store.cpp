@@ -11,7 +11,7 @@
 #include "headers.h"
 
 // Save the store's last increment value.
-static int16_t store_last_increment;
+static thread_local int16_t store_last_increment;
 
 static bool storeNoNeedToBargain(Store_t const &store, int32_t min_price);
 static void storeUpdateBargainingSkills(Store_t &store, int32_t price, int32_t min_price);
@@ -45,7 +45,7 @@ typedef struct {
 extern uint8_t race_gold_adjustments[PLAYER_MAX_RACES][PLAYER_MAX_RACES];
 
 extern Owner_t store_owners[MAX_OWNERS];
-extern Store_t stores[MAX_STORES];
+extern thread_local Store_t stores[MAX_STORES];
 extern uint16_t store_choices[MAX_STORES][STORE_MAX_ITEM_TYPES];
 extern bool (*store_buy[MAX_STORES])(uint8_t);
 extern const char *speech_sale_accepted[14];
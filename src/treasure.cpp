@@ -823,7 +823,7 @@ static void cursedProjectileAdjustment(Inventory_t &item, int level) {
 
 // Counter for missiles
 // Note: converted to uint16_t when saving the game.
-int16_t missiles_counter = 0;
+thread_local int16_t missiles_counter = 0;
 
 static void magicalProjectile(Inventory_t &item, int special, int level, int chance, int cursed) {
     if (item.category_id == TV_SLING_AMMO || item.category_id == TV_BOLT || item.category_id == TV_ARROW) {
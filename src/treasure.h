@@ -72,6 +72,6 @@ constexpr uint8_t TV_SECRET_DOOR = 109;
 constexpr uint8_t TV_STORE_DOOR = 110;
 constexpr uint8_t TV_MAX_VISIBLE = 110;
 
-extern int16_t missiles_counter;
+extern thread_local int16_t missiles_counter;
 
 void magicTreasureMagicalAbility(int item_id, int level);
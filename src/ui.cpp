@@ -15,11 +15,9 @@ static const char *stat_names[] = {
 static char blank_string[] = "                        ";
 
 // Track screen changes for inventory commands
-bool screen_has_changed = false;
+thread_local bool screen_has_changed = false;
 
-bool message_ready_to_print;            // Set with first message
-vtype_t messages[MESSAGE_HISTORY_SIZE]; // Saved message history -CJS-
-int16_t last_message_id = 0;            // Index of last message held in saved messages array
+thread_local bool message_ready_to_print; // Set with first message
 
 // Calculates current boundaries -RAK-
 static void panelBounds() {
@@ -82,22 +80,15 @@ bool coordInsidePanel(Coord_t coord) {
 }
 
 // Prints the map of the dungeon -RAK-
+// Every tile is put, blanks included, as panelPutTile() skips the ones already on screen.
 void drawDungeonPanel() {
-    int line = 1;
-
     Coord_t coord = Coord_t{0, 0};
 
     // Top to bottom
     for (coord.y = dg.panel.top; coord.y <= dg.panel.bottom; coord.y++) {
-        eraseLine(Coord_t{line, 13});
-        line++;
-
         // Left to right
         for (coord.x = dg.panel.left; coord.x <= dg.panel.right; coord.x++) {
-            char ch = caveGetTileSymbol(coord);
-            if (ch != ' ') {
-                panelPutTile(ch, coord);
-            }
+            panelPutTile(caveGetTileSymbol(coord), coord);
         }
     }
 }
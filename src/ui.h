@@ -29,9 +29,17 @@ typedef struct {
 // message line location
 constexpr uint8_t MSG_LINE = 0;
 
-// How many messages to save in the buffer -CJS-
+// How many messages the message review screen shows, and save files keep -CJS-
 constexpr uint8_t MESSAGE_HISTORY_SIZE = 22;
 
+// The message log keeps the last MESSAGE_LOG_SIZE messages, as long as
+// their text fits in MESSAGE_LOG_TEXT_SIZE characters.
+constexpr uint16_t MESSAGE_LOG_SIZE = 4096;
+constexpr uint32_t MESSAGE_LOG_TEXT_SIZE = 256 * 1024;
+
+// Longest message the log keeps, longer ones are cut short
+constexpr uint16_t MESSAGE_LOG_LINE_SIZE = 256;
+
 // Column for stats
 constexpr uint8_t STAT_COLUMN = 0;
 
@@ -45,21 +53,33 @@ constexpr char DELETE = 0x7f;
 #undef ESCAPE
 constexpr char ESCAPE = '\033'; // ESCAPE character -CJS-
 
-extern bool screen_has_changed;
-extern bool message_ready_to_print;
-extern vtype_t messages[MESSAGE_HISTORY_SIZE];
-extern int16_t last_message_id;
+// What a game was started with, for its journal to start it the same way
+typedef struct {
+    uint32_t seed;
+    bool new_game;
+    bool wizard;
+} JournalStart_t;
+
+extern thread_local bool screen_has_changed;
+extern thread_local bool message_ready_to_print;
 
-extern int eof_flag;
-extern bool panic_save;
+extern thread_local int eof_flag;
+extern thread_local bool panic_save;
 
 // UI - IO
 bool terminalInitialize();
+bool terminalInitializeHeadless(const char *key_script);
+bool terminalInitializeReplay(const char *filename, JournalStart_t &start);
+bool terminalRecordJournal(const char *filename, JournalStart_t const &start);
+bool journalOutcome(bool outcome);
+void terminalSetHeadlessInputCallback(int (*callback)());
+bool terminalIsHeadless();
 void terminalRestore();
 void terminalSaveScreen();
 void terminalRestoreScreen();
 ssize_t terminalBellSound();
 void putQIO();
+void putQIOFrame();
 void flushInputBuffer();
 void clearScreen();
 void clearToBottom(int row);
@@ -74,12 +94,17 @@ void messageLinePrintMessage(std::string message);
 void messageLineClear();
 void printMessage(const char *msg);
 void printMessageNoCommandInterrupt(const std::string &msg);
+void messageLogAdd(const char *msg);
+const char *messageLogEntry(int age);
+int messageLogCount();
+void messageLogClear();
 char getKeyInput();
+char getCommandKeyInput();
 bool getCommand(const std::string &prompt, char &command);
 bool getStringInput(char *in_str, Coord_t coord, int slen);
 bool getInputConfirmation(const std::string &prompt);
 void waitForContinueKey(int line_number);
-bool checkForNonBlockingKeyPress(int microseconds);
+bool checkForNonBlockingKeyPress();
 void getDefaultPlayerName(char *buffer);
 bool checkFilePermissions();
 
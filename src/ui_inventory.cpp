@@ -275,8 +275,8 @@ constexpr int HELP_SCR = 4;
 constexpr int WRONG_SCR = 5;
 
 // Keep track of the state of the inventory screen.
-int screen_state, screen_left, screen_base;
-int wear_low, wear_high;
+static thread_local int screen_state, screen_left, screen_base;
+static thread_local int wear_low, wear_high;
 
 static void uiCommandDisplayInventoryScreen(int new_screen) {
     if (new_screen == screen_state) {
@@ -8,17 +8,87 @@
 
 // Terminal I/O code, uses the curses package
 
+#include <chrono>
 #include <cstdlib>
+#include <vector>
 #include "headers.h"
 #include "curses.h"
 
 static bool curses_on = false;
 
+static bool terminalReadPendingKey();
+
+// Headless mode: curses is never started, all rendering calls are no-ops,
+// and the keys come from a key script and/or a bot callback.
+static thread_local bool headless = false;
+static thread_local std::string headless_keys;
+static thread_local size_t headless_key_index = 0;
+static thread_local int (*headless_input_callback)() = nullptr;
+
+// A journal records a game so that it can be replayed exactly: a text header
+// with the seed and options the game started with, then every key that
+// getKeyInput() returned. A JOURNAL_ESCAPE byte starts one of three events,
+// another JOURNAL_ESCAPE being that key itself, JOURNAL_INTERRUPT, then
+// a 4 byte count, being a key that interrupted that numbered call to
+// checkForNonBlockingKeyPress() since the last key, and JOURNAL_OUTCOME,
+// then a 0 or 1 byte, being how a file operation went, see journalOutcome().
+constexpr uint8_t JOURNAL_ESCAPE = 0xff;
+constexpr uint8_t JOURNAL_INTERRUPT = 'i';
+constexpr uint8_t JOURNAL_OUTCOME = 'o';
+
+typedef struct {
+    size_t key_index; // Keys returned before the interrupt
+    uint32_t check;   // Key checks since the last of them
+} JournalInterrupt_t;
+
+static thread_local FILE *journal_file = nullptr;
+static thread_local std::vector<JournalInterrupt_t> replay_interrupts;
+static thread_local size_t replay_interrupt_index = 0;
+static thread_local std::vector<bool> replay_outcomes;
+static thread_local size_t replay_outcome_index = 0;
+
+// Calls to checkForNonBlockingKeyPress() since getKeyInput() last returned
+static thread_local uint32_t key_checks = 0;
+
 // Spare window for saving the screen. -CJS-
 static WINDOW *save_screen;
 
-int eof_flag = 0;        // Is used to signal EOF/HANGUP condition
-bool panic_save = false; // True if playing from a panic save
+// A shadow of the dungeon panel part of the screen, holding what curses was last
+// given for each cell, so panelPutTile() only passes on the tiles that changed.
+// Every other write to the screen keeps it in step; a '\0' cell is unknown.
+constexpr int PANEL_SCREEN_ROW = 1;
+constexpr int PANEL_SCREEN_COL = 13;
+static char panel_shadow[SCREEN_HEIGHT][SCREEN_WIDTH];
+
+// Set when curses has been given something new to show, so that putQIO()
+// only calls refresh() when it has something to do.
+static bool screen_dirty = false;
+
+// Earliest time putQIOFrame() may refresh the screen again
+static std::chrono::steady_clock::time_point screen_next_frame;
+
+static void panelShadowFill(int row, int from_col, int to_col, char ch) {
+    row -= PANEL_SCREEN_ROW;
+    if (row < 0 || row >= SCREEN_HEIGHT) {
+        return;
+    }
+
+    from_col = std::max(from_col - PANEL_SCREEN_COL, 0);
+    to_col = std::min(to_col - PANEL_SCREEN_COL, SCREEN_WIDTH - 1);
+
+    for (int col = from_col; col <= to_col; col++) {
+        panel_shadow[row][col] = ch;
+    }
+}
+
+static void panelShadowFillRows(int from_row, char ch) {
+    for (int row = from_row; row < PANEL_SCREEN_ROW + SCREEN_HEIGHT; row++) {
+        panelShadowFill(row, 0, 79, ch);
+    }
+}
+
+thread_local int eof_flag = 0;        // Is used to signal EOF/HANGUP condition
+thread_local bool panic_save = false; // True if playing from a panic save
 
 // Set up the terminal into a suitable state -MRC-
 static void moriaTerminalInitialize() {
@@ -56,10 +126,189 @@ bool terminalInitialize() {
 
     (void) clear();
     (void) refresh();
+    panelShadowFillRows(0, ' ');
+
+    return true;
+}
+
+// Initializes the headless backend, reading all keys of the optional
+// `key_script` file into memory. Returns false if the file can't be read.
+bool terminalInitializeHeadless(const char *key_script) {
+    headless = true;
+    headless_keys.clear();
+    headless_key_index = 0;
+    replay_interrupts.clear();
+    replay_interrupt_index = 0;
+    replay_outcomes.clear();
+    replay_outcome_index = 0;
+
+    if (key_script == nullptr) {
+        return true;
+    }
+
+    FILE *file = fopen(key_script, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    int ch;
+    while ((ch = getc(file)) != EOF) {
+        headless_keys.push_back((char) ch);
+    }
+
+    (void) fclose(file);
 
     return true;
 }
 
+// Starts writing a journal of the game to `filename`, which is
+// started with `start`. Returns false if the file can't be written.
+bool terminalRecordJournal(const char *filename, JournalStart_t const &start) {
+    journal_file = fopen(filename, "wb");
+    if (journal_file == nullptr) {
+        return false;
+    }
+
+    (void) fprintf(journal_file, "umoria journal\nseed %u\nnew_game %d\nwizard %d\nkeys\n", start.seed, (int) start.new_game, (int) start.wizard);
+
+    return fflush(journal_file) == 0;
+}
+
+// Every key is flushed at once, so that the journal of a crashed game is complete.
+static void journalWrite(const uint8_t *bytes, size_t count) {
+    if (journal_file == nullptr) {
+        return;
+    }
+
+    (void) fwrite(bytes, 1, count, journal_file);
+    (void) fflush(journal_file);
+}
+
+static void journalRecordKey(char key) {
+    uint8_t bytes[] = {JOURNAL_ESCAPE, (uint8_t) key};
+
+    if (bytes[1] == JOURNAL_ESCAPE) {
+        journalWrite(bytes, 2);
+    } else {
+        journalWrite(&bytes[1], 1);
+    }
+}
+
+static void journalRecordInterrupt() {
+    uint8_t bytes[] = {
+        JOURNAL_ESCAPE,
+        JOURNAL_INTERRUPT,
+        (uint8_t) key_checks,
+        (uint8_t) (key_checks >> 8),
+        (uint8_t) (key_checks >> 16),
+        (uint8_t) (key_checks >> 24),
+    };
+    journalWrite(bytes, sizeof(bytes));
+}
+
+// The save file code asks this how each of its file operations went, giving
+// the `outcome` it had. A replay is told the outcome it had when it was
+// recorded, so that it takes the same prompts, messages and random numbers
+// without touching the file, and a game being recorded puts it in the journal.
+bool journalOutcome(bool outcome) {
+    if (headless) {
+        if (replay_outcome_index < replay_outcomes.size()) {
+            return replay_outcomes[replay_outcome_index++];
+        }
+        return outcome;
+    }
+
+    uint8_t bytes[] = {JOURNAL_ESCAPE, JOURNAL_OUTCOME, (uint8_t) outcome};
+    journalWrite(bytes, sizeof(bytes));
+
+    return outcome;
+}
+
+static bool journalReadHeaderLine(FILE *file, const char *format, int &value) {
+    char line[80];
+    return fgets(line, sizeof(line), file) != nullptr && sscanf(line, format, &value) == 1;
+}
+
+// Initializes the headless backend to replay the journal in `filename`,
+// and tells what its game was started with. Returns false if the
+// file can't be read, or isn't a journal.
+bool terminalInitializeReplay(const char *filename, JournalStart_t &start) {
+    if (!terminalInitializeHeadless(nullptr)) {
+        return false;
+    }
+
+    FILE *file = fopen(filename, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    char line[80];
+    int seed = 0;
+    int new_game = 0;
+    int wizard = 0;
+
+    bool valid = fgets(line, sizeof(line), file) != nullptr && strcmp(line, "umoria journal\n") == 0 && //
+                 journalReadHeaderLine(file, "seed %d", seed) &&                                          //
+                 journalReadHeaderLine(file, "new_game %d", new_game) &&                                  //
+                 journalReadHeaderLine(file, "wizard %d", wizard) &&                                      //
+                 fgets(line, sizeof(line), file) != nullptr && strcmp(line, "keys\n") == 0;
+
+    int ch;
+    while (valid && (ch = getc(file)) != EOF) {
+        if (ch != JOURNAL_ESCAPE) {
+            headless_keys.push_back((char) ch);
+            continue;
+        }
+
+        ch = getc(file);
+        if (ch == JOURNAL_ESCAPE) {
+            headless_keys.push_back((char) ch);
+        } else if (ch == JOURNAL_INTERRUPT) {
+            uint32_t check = 0;
+            for (int i = 0; i < 4 && (ch = getc(file)) != EOF; i++) {
+                check |= (uint32_t) ch << (8 * i);
+            }
+            replay_interrupts.push_back(JournalInterrupt_t{headless_keys.size(), check});
+        } else if (ch == JOURNAL_OUTCOME) {
+            ch = getc(file);
+            valid = ch == 0 || ch == 1;
+            replay_outcomes.push_back(ch == 1);
+        } else {
+            valid = false;
+        }
+    }
+
+    (void) fclose(file);
+
+    start.seed = (uint32_t) seed;
+    start.new_game = new_game != 0;
+    start.wizard = wizard != 0;
+
+    return valid;
+}
+
+// Keys are requested from the bot `callback` once the key script
+// has been used up. The callback returns -1 when it has no more keys.
+void terminalSetHeadlessInputCallback(int (*callback)()) {
+    headless_input_callback = callback;
+}
+
+bool terminalIsHeadless() {
+    return headless;
+}
+
+static int headlessNextKey() {
+    if (headless_key_index < headless_keys.size()) {
+        return (uint8_t) headless_keys[headless_key_index++];
+    }
+
+    if (headless_input_callback != nullptr) {
+        return headless_input_callback();
+    }
+
+    return EOF;
+}
+
 // Put the terminal in the original mode. -CJS-
 void terminalRestore() {
     if (!curses_on) {
@@ -83,15 +332,29 @@ void terminalRestore() {
 }
 
 void terminalSaveScreen() {
+    if (headless) {
+        return;
+    }
+
     overwrite(stdscr, save_screen);
 }
 
 void terminalRestoreScreen() {
+    if (headless) {
+        return;
+    }
+
     overwrite(save_screen, stdscr);
     touchwin(stdscr);
+    panelShadowFillRows(0, '\0');
+    screen_dirty = true;
 }
 
 ssize_t terminalBellSound() {
+    if (headless) {
+        return 0;
+    }
+
     putQIO();
 
     // The player can turn off beeps if they find them annoying.
@@ -107,16 +370,39 @@ void putQIO() {
     // Let inventoryExecuteCommand() know something has changed.
     screen_has_changed = true;
 
+    if (headless || !screen_dirty) {
+        return;
+    }
+
     (void) refresh();
+    screen_dirty = false;
+    screen_next_frame = std::chrono::steady_clock::now() + std::chrono::microseconds(1000000) / std::max((int) config::options::run_frame_rate, 1);
+}
+
+// Dumps the IO buffer for one step of a run, rest or repeated command.
+// The screen is refreshed at most config::options::run_frame_rate times a
+// second; what's held back is shown by the next putQIO(), at the latest
+// when getKeyInput() waits for the next command.
+void putQIOFrame() {
+    screen_has_changed = true;
+
+    if (headless || !screen_dirty || config::options::run_frame_rate == 0) {
+        return;
+    }
+
+    if (std::chrono::steady_clock::now() >= screen_next_frame) {
+        putQIO();
+    }
 }
 
 // Flush the buffer -RAK-
 void flushInputBuffer() {
-    if (eof_flag != 0) {
+    // There is no type-ahead to throw away in a key script
+    if (eof_flag != 0 || headless) {
         return;
     }
 
-    while (checkForNonBlockingKeyPress(0))
+    while (terminalReadPendingKey())
         ;
 }
 
@@ -125,27 +411,55 @@ void clearScreen() {
     if (message_ready_to_print) {
         printMessage(CNIL);
     }
+
+    if (headless) {
+        return;
+    }
+
     (void) clear();
+    panelShadowFillRows(0, ' ');
+    screen_dirty = true;
 }
 
 void clearToBottom(int row) {
+    if (headless) {
+        return;
+    }
+
     (void) move(row, 0);
     clrtobot();
+    panelShadowFillRows(row, ' ');
+    screen_dirty = true;
 }
 
 // move cursor to a given y, x position
 void moveCursor(Coord_t coord) {
+    if (headless) {
+        return;
+    }
+
     (void) move(coord.y, coord.x);
+    screen_dirty = true;
 }
 
 void addChar(char ch, Coord_t coord) {
+    if (headless) {
+        return;
+    }
+
     if (mvaddch(coord.y, coord.x, ch) == ERR) {
         abort();
     }
+    panelShadowFill(coord.y, coord.x, coord.x, ch);
+    screen_dirty = true;
 }
 
 // Dump IO to buffer -RAK-
 void putString(const char *out_str, Coord_t coord) {
+    if (headless) {
+        return;
+    }
+
     // truncate the string, to make sure that it won't go past right edge of screen.
     if (coord.x > 79) {
         coord.x = 79;
@@ -158,6 +472,17 @@ void putString(const char *out_str, Coord_t coord) {
     if (mvaddstr(coord.y, coord.x, str) == ERR) {
         abort();
     }
+
+    for (int i = 0; str[i] != '\0'; i++) {
+        // A newline (or any control character) moves curses on in ways not worth following
+        if (iscntrl((uint8_t) str[i]) != 0) {
+            panelShadowFill(coord.y, coord.x + i, 79, '\0');
+            panelShadowFillRows(coord.y + 1, '\0');
+            break;
+        }
+        panelShadowFill(coord.y, coord.x + i, coord.x + i, str[i]);
+    }
+    screen_dirty = true;
 }
 
 // Outputs a line to a given y, x position -RAK-
@@ -166,8 +491,13 @@ void putStringClearToEOL(const std::string &str, Coord_t coord) {
         printMessage(CNIL);
     }
 
+    if (headless) {
+        return;
+    }
+
     (void) move(coord.y, coord.x);
     clrtoeol();
+    panelShadowFill(coord.y, coord.x, 79, ' ');
     putString(str.c_str(), coord);
 }
 
@@ -177,12 +507,22 @@ void eraseLine(Coord_t coord) {
         printMessage(CNIL);
     }
 
+    if (headless) {
+        return;
+    }
+
     (void) move(coord.y, coord.x);
     clrtoeol();
+    panelShadowFill(coord.y, coord.x, 79, ' ');
+    screen_dirty = true;
 }
 
 // Moves the cursor to a given interpolated y, x position -RAK-
 void panelMoveCursor(Coord_t coord) {
+    if (headless) {
+        return;
+    }
+
     // Real coords convert to screen positions
     coord.y -= dg.panel.row_prt;
     coord.x -= dg.panel.col_prt;
@@ -190,18 +530,36 @@ void panelMoveCursor(Coord_t coord) {
     if (move(coord.y, coord.x) == ERR) {
         abort();
     }
+    screen_dirty = true;
 }
 
 // Outputs a char to a given interpolated y, x position -RAK-
 // sign bit of a character used to indicate standout mode. -CJS
 void panelPutTile(char ch, Coord_t coord) {
+    if (headless) {
+        return;
+    }
+
     // Real coords convert to screen positions
     coord.y -= dg.panel.row_prt;
     coord.x -= dg.panel.col_prt;
 
+    int row = coord.y - PANEL_SCREEN_ROW;
+    int col = coord.x - PANEL_SCREEN_COL;
+    bool in_shadow = row >= 0 && row < SCREEN_HEIGHT && col >= 0 && col < SCREEN_WIDTH;
+
+    if (in_shadow && panel_shadow[row][col] == ch) {
+        return;
+    }
+
     if (mvaddch(coord.y, coord.x, ch) == ERR) {
         abort();
     }
+
+    if (in_shadow) {
+        panel_shadow[row][col] = ch;
+    }
+    screen_dirty = true;
 }
 
 static Coord_t currentCursorPosition() {
@@ -213,6 +571,10 @@ static Coord_t currentCursorPosition() {
 // messageLinePrintMessage will print a line of text to the message line (0,0).
 // first clearing the line of any text!
 void messageLinePrintMessage(std::string message) {
+    if (headless) {
+        return;
+    }
+
     // save current cursor position
     Coord_t coord = currentCursorPosition();
 
@@ -227,11 +589,16 @@ void messageLinePrintMessage(std::string message) {
 
     // restore cursor to old position
     move(coord.y, coord.x);
+    screen_dirty = true;
 }
 
 // deleteMessageLine will delete all text from the message line (0,0).
 // The current cursor position will be maintained.
 void messageLineClear() {
+    if (headless) {
+        return;
+    }
+
     // save current cursor position
     Coord_t coord = currentCursorPosition();
 
@@ -241,6 +608,120 @@ void messageLineClear() {
 
     // restore cursor to old position
     move(coord.y, coord.x);
+    screen_dirty = true;
+}
+
+// The message log is a ring of entries, each pointing at its text in a ring
+// of characters. A message's text is never split across the end of that ring,
+// and adding one drops the oldest messages, once either ring is full.
+// Nothing is ever allocated, so a long game keeps its full combat log for free.
+typedef struct {
+    uint32_t start;  // Where the text starts in the text ring
+    uint16_t length; // Length of the text, without its '\0'
+} MessageLogEntry_t;
+
+static thread_local MessageLogEntry_t message_log[MESSAGE_LOG_SIZE];
+static thread_local char message_log_text[MESSAGE_LOG_TEXT_SIZE];
+static thread_local uint16_t message_log_oldest = 0;
+static thread_local uint16_t message_log_count = 0;
+static thread_local uint32_t message_log_text_end = 0; // Where the next text goes
+
+// With config::options::batch_messages, printMessage() never asks for -more-.
+// Message lines the message line moved past are instead shown together,
+// before the next command.
+static thread_local int message_batch_lines = 0;        // Message lines since the last command
+static thread_local bool message_batch_skipped = false; // Some of them were never waited on
+
+static MessageLogEntry_t &messageLogNewest() {
+    return message_log[(message_log_oldest + message_log_count - 1) % MESSAGE_LOG_SIZE];
+}
+
+static void messageLogDropOldest() {
+    message_log_oldest = (uint16_t) ((message_log_oldest + 1) % MESSAGE_LOG_SIZE);
+    message_log_count--;
+}
+
+// The oldest messages are the ones stored right after the text end, if any
+// are, so making room for a text drops them until they're clear of it.
+static void messageLogMakeRoom(uint32_t size) {
+    if (message_log_count == MESSAGE_LOG_SIZE) {
+        messageLogDropOldest();
+    }
+
+    if (message_log_text_end + size > MESSAGE_LOG_TEXT_SIZE) {
+        while (message_log_count > 0 && message_log[message_log_oldest].start >= message_log_text_end) {
+            messageLogDropOldest();
+        }
+        message_log_text_end = 0;
+    }
+
+    while (message_log_count > 0) {
+        uint32_t start = message_log[message_log_oldest].start;
+        if (start < message_log_text_end || start >= message_log_text_end + size) {
+            break;
+        }
+        messageLogDropOldest();
+    }
+}
+
+// Adds a message to the log, without showing it
+void messageLogAdd(const char *msg) {
+    auto length = (uint16_t) std::min(strlen(msg), (size_t) MESSAGE_LOG_LINE_SIZE - 1);
+
+    messageLogMakeRoom((uint32_t) length + 1);
+
+    char *text = &message_log_text[message_log_text_end];
+    (void) memcpy(text, msg, length);
+    text[length] = '\0';
+
+    message_log_count++;
+    messageLogNewest() = MessageLogEntry_t{message_log_text_end, length};
+    message_log_text_end += length + 1;
+}
+
+// Adds a message to the end of the newest one, two spaces apart.
+static void messageLogCombine(const char *msg) {
+    if (message_log_count == 0) {
+        messageLogAdd(msg);
+        return;
+    }
+
+    MessageLogEntry_t newest = messageLogNewest();
+
+    // Both are copied by hand, as messageLogAdd() cuts the line to size anyway
+    char line[MESSAGE_LOG_LINE_SIZE * 2 + 2];
+    size_t length = std::min((size_t) newest.length, (size_t) MESSAGE_LOG_LINE_SIZE - 1);
+    (void) memcpy(line, &message_log_text[newest.start], length);
+    (void) memcpy(&line[length], "  ", 2);
+    length += 2;
+
+    size_t msg_length = std::min(strlen(msg), (size_t) MESSAGE_LOG_LINE_SIZE - 1);
+    (void) memcpy(&line[length], msg, msg_length);
+    line[length + msg_length] = '\0';
+
+    // Its text is the last one written, so the combined text can take its place.
+    message_log_count--;
+    message_log_text_end = newest.start;
+    messageLogAdd(line);
+}
+
+// Returns a logged message, 0 being the newest one. Those
+// older than the oldest message the log has are empty.
+const char *messageLogEntry(int age) {
+    if (age < 0 || age >= message_log_count) {
+        return "";
+    }
+    return &message_log_text[message_log[(message_log_oldest + message_log_count - 1 - age) % MESSAGE_LOG_SIZE].start];
+}
+
+int messageLogCount() {
+    return message_log_count;
+}
+
+void messageLogClear() {
+    message_log_oldest = 0;
+    message_log_count = 0;
+    message_log_text_end = 0;
 }
 
 // Outputs message to top line of screen
@@ -251,7 +732,7 @@ void printMessage(const char *msg) {
     bool combine_messages = false;
 
     if (message_ready_to_print) {
-        old_len = (int) strlen(messages[last_message_id]) + 1;
+        old_len = (int) strlen(messageLogEntry(0)) + 1;
 
         // If the new message and the old message are short enough,
         // we want display them together on the same line.  So we
@@ -263,7 +744,11 @@ void printMessage(const char *msg) {
             new_len = 0;
         }
 
-        if ((msg == nullptr) || new_len + old_len + 2 >= 73) {
+        if (((msg == nullptr) || new_len + old_len + 2 >= 73) && config::options::batch_messages) {
+            // The message line moves on without waiting, the skipped
+            // lines are shown before the next command.
+            message_batch_skipped = true;
+        } else if ((msg == nullptr) || new_len + old_len + 2 >= 73) {
             // ensure that the complete -more- message is visible.
             if (old_len > 73) {
                 old_len = 73;
@@ -280,9 +765,10 @@ void printMessage(const char *msg) {
         }
     }
 
-    if (!combine_messages) {
+    if (!combine_messages && !headless) {
         (void) move(MSG_LINE, 0);
         clrtoeol();
+        screen_dirty = true;
     }
 
     // Make the null string a special case. -CJS-
@@ -300,19 +786,52 @@ void printMessage(const char *msg) {
 
     if (combine_messages) {
         putString(msg, Coord_t{MSG_LINE, old_len + 2});
-        strcat(messages[last_message_id], "  ");
-        strcat(messages[last_message_id], msg);
+        messageLogCombine(msg);
     } else {
         messageLinePrintMessage(msg);
-        last_message_id++;
+        messageLogAdd(msg);
+        message_batch_lines++;
+    }
+}
 
-        if (last_message_id >= MESSAGE_HISTORY_SIZE) {
-            last_message_id = 0;
-        }
+// Shows the message lines of the last turn above the message line, when
+// the message line skipped some of them. Returns true when it saved the
+// screen to do so. Headless games only keep them in the message log.
+static bool messageBatchShow() {
+    bool show = message_batch_skipped && !headless;
+    int lines = std::min(message_batch_lines, (int) MESSAGE_HISTORY_SIZE);
+
+    message_batch_skipped = false;
+    message_batch_lines = 0;
+
+    if (!show) {
+        return false;
+    }
+
+    message_ready_to_print = false;
+    terminalSaveScreen();
+
+    for (int age = 0; age < lines; age++) {
+        putStringClearToEOL(messageLogEntry(age), Coord_t{lines - 1 - age, 0});
+    }
+    eraseLine(Coord_t{lines, 0});
+
+    return true;
+}
+
+// Reads the key of the next command. With batched messages, the lines
+// the message line skipped in the last turn stay on screen until it's
+// pressed, so they take no extra keys to read.
+char getCommandKeyInput() {
+    bool shown = messageBatchShow();
 
-        (void) strncpy(messages[last_message_id], msg, MORIA_MESSAGE_SIZE);
-        messages[last_message_id][MORIA_MESSAGE_SIZE - 1] = '\0';
+    char key = getKeyInput();
+
+    if (shown) {
+        terminalRestoreScreen();
     }
+
+    return key;
 }
 
 // Print a message so as not to interrupt a counted command. -CJS-
@@ -326,6 +845,13 @@ void printMessageNoCommandInterrupt(const std::string &msg) {
     game.command_count = i;
 }
 
+// Every key getKeyInput() returns goes into the journal, if one is being written.
+static char keyInputReturn(char key) {
+    key_checks = 0;
+    journalRecordKey(key);
+    return key;
+}
+
 // Returns a single character input from the terminal. -CJS-
 //
 // This silently consumes ^R to redraw the screen and reset the
@@ -335,6 +861,22 @@ char getKeyInput() {
     putQIO();               // Dump IO buffer
     game.command_count = 0; // Just to be safe -CJS-
 
+    if (headless) {
+        int ch = headlessNextKey();
+
+        // Running out of keys ends a headless game, as there is nobody left to ask.
+        if (ch == EOF) {
+            message_ready_to_print = false;
+
+            if (!game.character_is_dead) {
+                (void) strcpy(game.character_died_from, "(end of input)");
+            }
+            endGame();
+        }
+
+        return keyInputReturn((char) ch);
+    }
+
     while (true) {
         int ch = getch();
 
@@ -364,11 +906,11 @@ char getKeyInput() {
                 }
                 endGame();
             }
-            return ESCAPE;
+            return keyInputReturn(ESCAPE);
         }
 
         if (ch != CTRL_KEY('R')) {
-            return (char) ch;
+            return keyInputReturn((char) ch);
         }
 
         (void) wrefresh(curscr);
@@ -392,13 +934,17 @@ bool getCommand(const std::string &prompt, char &command) {
 // Gets a string terminated by <RETURN>
 // Function returns false if <ESCAPE> is input
 bool getStringInput(char *in_str, Coord_t coord, int slen) {
-    (void) move(coord.y, coord.x);
+    if (!headless) {
+        (void) move(coord.y, coord.x);
 
-    for (int i = slen; i > 0; i--) {
-        (void) addch(' ');
-    }
+        for (int i = slen; i > 0; i--) {
+            (void) addch(' ');
+        }
+        panelShadowFill(coord.y, coord.x, coord.x + slen - 1, ' ');
 
-    (void) move(coord.y, coord.x);
+        (void) move(coord.y, coord.x);
+        screen_dirty = true;
+    }
 
     int start_col = coord.x;
     int end_col = coord.x + slen - 1;
@@ -435,7 +981,11 @@ bool getStringInput(char *in_str, Coord_t coord, int slen) {
                 if ((isprint(key) == 0) || coord.x > end_col) {
                     terminalBellSound();
                 } else {
-                    mvaddch(coord.y, coord.x, (char) key);
+                    if (!headless) {
+                        (void) mvaddch(coord.y, coord.x, (char) key);
+                        panelShadowFill(coord.y, coord.x, coord.x, (char) key);
+                        screen_dirty = true;
+                    }
                     *p++ = (char) key;
                     coord.x++;
                 }
@@ -460,16 +1010,19 @@ bool getStringInput(char *in_str, Coord_t coord, int slen) {
 bool getInputConfirmation(const std::string &prompt) {
     putStringClearToEOL(prompt, Coord_t{0, 0});
 
-    int y, x;
-    getyx(stdscr, y, x);
+    if (!headless) {
+        int y, x;
+        getyx(stdscr, y, x);
 
-    if (x > 73) {
-        (void) move(0, 73);
-    } else if (y != 0) {
-        // use `y` to prevent compiler warning.
-    }
+        if (x > 73) {
+            (void) move(0, 73);
+        } else if (y != 0) {
+            // use `y` to prevent compiler warning.
+        }
 
-    (void) addstr(" [y/n]");
+        (void) addstr(" [y/n]");
+        screen_dirty = true;
+    }
 
     char input = ' ';
     while (input == ' ') {
@@ -488,41 +1041,51 @@ void waitForContinueKey(int line_number) {
     eraseLine(Coord_t{line_number, 0});
 }
 
-// Provides for a timeout on input. Does a non-blocking read, consuming the data if
-// any, and then returns 1 if data was read, zero otherwise.
-//
-// Porting:
-//
-// In systems without the select call, but with a sleep for fractional numbers of
-// seconds, one could sleep for the time and then check for input.
-//
-// In systems which can only sleep for whole number of seconds, you might sleep by
-// writing a lot of nulls to the terminal, and waiting for them to drain, or you
-// might hack a static accumulation of times to wait. When the accumulation reaches
-// a certain point, sleep for a second. There would need to be a way of resetting
-// the count, with a call made for commands like run or rest.
-bool checkForNonBlockingKeyPress(int microseconds) {
-#ifdef _WIN32
-    (void) microseconds;
+// Checks for a key press without ever waiting for one. Does a non-blocking
+// read, consuming the data if any, and then returns true if data was read.
+bool checkForNonBlockingKeyPress() {
+    key_checks++;
+
+    // A key script can't be typed ahead, so only the interrupts of a
+    // replayed journal ever interrupt a headless game.
+    if (headless) {
+        if (replay_interrupt_index < replay_interrupts.size()) {
+            JournalInterrupt_t const &interrupt = replay_interrupts[replay_interrupt_index];
 
-    // Ugly non-blocking read...Ugh! -MRC-
-    timeout(8);
+            if (interrupt.key_index == headless_key_index && interrupt.check == key_checks) {
+                replay_interrupt_index++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (!terminalReadPendingKey()) {
+        return false;
+    }
+
+    journalRecordInterrupt();
+    return true;
+}
+
+// Reads a key, if one has been typed, without waiting for one.
+static bool terminalReadPendingKey() {
+#ifdef _WIN32
+    nodelay(stdscr, true);
     int result = getch();
-    timeout(-1);
+    nodelay(stdscr, false);
 
-    return result > 0;
+    return result != ERR;
 #else
-    struct timeval tbuf {};
-    int ch;
-    int smask;
+    // A zero timeout makes select() report at once whether a read on stdin would block.
+    struct timeval no_wait {};
 
-    // Return true if a read on descriptor 1 will not block.
-    tbuf.tv_sec = 0;
-    tbuf.tv_usec = microseconds;
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(STDIN_FILENO, &read_fds);
 
-    smask = 1; // i.e. (1 << 0)
-    if (select(1, (fd_set *) &smask, (fd_set *) nullptr, (fd_set *) nullptr, &tbuf) == 1) {
-        ch = getch();
+    if (select(STDIN_FILENO + 1, &read_fds, nullptr, nullptr, &no_wait) == 1) {
+        int ch = getch();
         // check for EOF errors here, select sometimes works even when EOF
         if (ch == -1) {
             eof_flag++;
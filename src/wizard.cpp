@@ -123,24 +123,34 @@ void wizardSummonMonster() {
 
 // Light up the dungeon -RAK-
 void wizardLightUpDungeon() {
-    bool flag;
+    bool flag = !dg.floor[py.pos.y][py.pos.x].permanent_light;
 
-    flag = !dg.floor[py.pos.y][py.pos.x].permanent_light;
+    // The floor tiles, and those next to them, for each row
+    uint64_t around[MAX_HEIGHT][FLOOR_ROW_WORDS] = {};
+
+    for (int y = 1; y < dg.height - 1; y++) {
+        uint64_t floors[FLOOR_ROW_WORDS];
+        floorRowFeatureMask(floors, y, 0, dg.width - 1, 0, MAX_CAVE_FLOOR);
+        floorRowSpread(floors);
+
+        for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+            around[y - 1][word] |= floors[word];
+            around[y][word] |= floors[word];
+            around[y + 1][word] |= floors[word];
+        }
+    }
 
     for (int y = 0; y < dg.height; y++) {
-        for (int x = 0; x < dg.width; x++) {
-            if (dg.floor[y][x].feature_id <= MAX_CAVE_FLOOR) {
-                for (int yy = y - 1; yy <= y + 1; yy++) {
-                    for (int xx = x - 1; xx <= x + 1; xx++) {
-                        dg.floor[yy][xx].permanent_light = flag;
-                        if (!flag) {
-                            dg.floor[yy][xx].field_mark = false;
-                        }
-                    }
-                }
+        for (int word = 0; word < FLOOR_ROW_WORDS; word++) {
+            if (flag) {
+                dg.floor.permanent_lights[y][word] |= around[y][word];
+            } else {
+                dg.floor.permanent_lights[y][word] &= ~around[y][word];
+                dg.floor.field_marks[y][word] &= ~around[y][word];
             }
         }
     }
+    floorGlyphsForgetAll();
 
     drawDungeonPanel();
 }
@@ -402,7 +412,7 @@ void wizardGenerateObject() {
 
             // place the object
             int free_treasure_id = popt();
-            dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+            treasurePutOnTile(coord, free_treasure_id);
             inventoryItemCopyTo(id, game.treasure.list[free_treasure_id]);
             magicTreasureMagicalAbility(free_treasure_id, dg.current_level);
 
@@ -556,7 +566,7 @@ void wizardCreateObjects() {
 
     if (getInputConfirmation("Allocate?")) {
         // delete object first if any, before call popt()
-        Tile_t &tile = dg.floor[py.pos.y][py.pos.x];
+        Tile_t tile = dg.floor[py.pos.y][py.pos.x];
 
         if (tile.treasure_id != 0) {
             (void) dungeonDeleteObject(py.pos);
@@ -565,7 +575,7 @@ void wizardCreateObjects() {
         number = popt();
 
         game.treasure.list[number] = forge;
-        tile.treasure_id = (uint8_t) number;
+        treasurePutOnTile(py.pos, number);
 
         printMessage("Allocated.");
     } else {